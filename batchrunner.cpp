@@ -0,0 +1,268 @@
+#include "batchrunner.h"
+#include "debugmanager.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace conf {
+namespace batch {
+
+constexpr int EXIT_GRACE = 5000;
+
+}
+}
+
+static QString quoted(const QString& expr)
+{
+    return QString{expr}.replace('\\', "\\\\").replace('"', "\\\"");
+}
+
+static QJsonObject frameToJson(const gdb::Frame& f)
+{
+    return {
+        { "level", f.level },
+        { "addr", QString{"0x%1"}.arg(f.addr, 0, 16) },
+        { "func", f.func },
+        { "file", f.fullpath.isEmpty()? f.file : f.fullpath },
+        { "line", f.line },
+    };
+}
+
+BatchJob::BatchJob(const QString &gdb, const QStringList &args, const QString &core,
+                   const QStringList &expressions, int timeoutSeconds, QObject *parent) :
+    QObject(parent),
+    m_debug(new DebugManager(this)),
+    m_timeout(new QTimer(this)),
+    m_core(core),
+    m_expressions(expressions)
+{
+    m_debug->setGdbCommand(gdb);
+    m_debug->setGdbArgs(args + QStringList{ "-c", core });
+    m_timeout->setSingleShot(true);
+    m_timeout->setInterval(timeoutSeconds * 1000);
+    connect(m_timeout, &QTimer::timeout, this, [this]() { fail(tr("timeout")); });
+    connect(m_debug, &DebugManager::started, this, &BatchJob::collect);
+    connect(m_debug, &DebugManager::gdbProcessTerminated, this, [this]() {
+        if (!m_finished)
+            fail(tr("gdb exited before the analysis completed"));
+    });
+}
+
+void BatchJob::start()
+{
+    m_result.insert("core", m_core);
+    m_clock.start();
+    m_timeout->start();
+    m_debug->execute();
+}
+
+void BatchJob::collect()
+{
+    request("-thread-info", [this](const QVariant& r) {
+        auto data = r.toMap();
+        auto current = data.value("current-thread-id").toInt();
+        m_result.insert("currentThread", current);
+        for (const auto& e: data.value("threads").toList()) {
+            auto t = gdb::Thread::parseMap(e.toMap());
+            m_threads.insert(t.id, QJsonObject{
+                { "id", t.id },
+                { "targetId", t.targetId },
+                { "name", t.name },
+            });
+            collectThread(t.id);
+        }
+        evaluate(current);
+    });
+}
+
+void BatchJob::collectThread(int id)
+{
+    request(QString{"-stack-list-frames --thread %1"}.arg(id), [this, id](const QVariant& r) {
+        QList<gdb::Frame> frames;
+        auto stack = r.toMap().value("stack").toList();
+        if (!stack.isEmpty())
+            for (const auto& e: stack.first().toMap().values("frame"))
+                frames.append(gdb::Frame::parseMap(e.toMap()));
+        std::sort(frames.begin(), frames.end(), [](const gdb::Frame& a, const gdb::Frame& b) {
+            return a.level < b.level;
+        });
+        QJsonArray backtrace;
+        for (const auto& f: frames)
+            backtrace.append(frameToJson(f));
+        m_threads[id].insert("frames", backtrace);
+    });
+    auto cmd = QString{"-stack-list-variables --thread %1 --frame 0 --simple-values"}.arg(id);
+    request(cmd, [this, id](const QVariant& r) {
+        QJsonArray locals;
+        for (const auto& e: r.toMap().value("variables").toList()) {
+            auto v = gdb::Variable::parseMap(e.toMap());
+            locals.append(QJsonObject{
+                { "name", v.name },
+                { "type", v.type },
+                { "value", v.value },
+            });
+        }
+        m_threads[id].insert("locals", locals);
+    });
+}
+
+void BatchJob::evaluate(int thread)
+{
+    for (const auto& expr: m_expressions) {
+        auto cmd = QString{"-data-evaluate-expression --thread %1 --frame 0 \"%2\""}.arg(thread).arg(quoted(expr));
+        request(cmd, [this, expr](const QVariant& r) {
+            m_values.append(QJsonObject{
+                { "expr", expr },
+                { "value", r.toMap().value("value").toString() },
+            });
+        }, [this, expr](const QVariant& r) {
+            m_values.append(QJsonObject{
+                { "expr", expr },
+                { "error", r.toMap().value("msg").toString() },
+            });
+        });
+    }
+}
+
+void BatchJob::request(const QString &cmd, const Handler_t &handler, const Handler_t &errorHandler)
+{
+    m_pending++;
+    m_debug->commandAndResponse(cmd, [this, handler](const QVariant& r) {
+        if (m_finished)
+            return;
+        handler(r);
+        settle();
+    }, [this, cmd, errorHandler](const QVariant& r) {
+        if (m_finished)
+            return;
+        if (errorHandler)
+            errorHandler(r);
+        else
+            m_errors.append(QJsonObject{
+                { "command", cmd },
+                { "msg", r.toMap().value("msg").toString() },
+            });
+        settle();
+    });
+}
+
+void BatchJob::settle()
+{
+    if (--m_pending == 0)
+        finish();
+}
+
+void BatchJob::fail(const QString &msg)
+{
+    if (m_finished)
+        return;
+    m_result.insert("error", msg);
+    finish();
+}
+
+void BatchJob::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    m_timeout->stop();
+    m_elapsed = m_clock.elapsed();
+    QJsonArray threads;
+    for (const auto& t: m_threads)
+        threads.append(t);
+    m_result.insert("threads", threads);
+    if (!m_expressions.isEmpty())
+        m_result.insert("expressions", m_values);
+    if (!m_errors.isEmpty())
+        m_result.insert("errors", m_errors);
+    m_result.insert("elapsedMs", double(m_elapsed));
+    if (m_debug->isGdbExecuting()) {
+        // Give gdb a chance to exit cleanly, a hung one is killed on deletion
+        connect(m_debug, &DebugManager::gdbProcessTerminated, this, &QObject::deleteLater);
+        QTimer::singleShot(conf::batch::EXIT_GRACE, this, &QObject::deleteLater);
+        m_debug->quit();
+    } else {
+        deleteLater();
+    }
+    emit finished();
+}
+
+BatchRunner::BatchRunner(QObject *parent) : QObject(parent)
+{
+}
+
+void BatchRunner::start()
+{
+    m_clock.start();
+    m_results.fill(QJsonObject{}, m_cores.size());
+    if (m_cores.isEmpty()) {
+        QTextStream(stderr) << tr("No core files given") << "\n";
+        emit finished(2);
+        return;
+    }
+    for (int i = 0; i < m_jobs; i++)
+        startNext();
+}
+
+void BatchRunner::startNext()
+{
+    if (m_next >= m_cores.size())
+        return;
+    int index = m_next++;
+    auto args = m_args;
+    if (!m_executable.isEmpty())
+        args.append(m_executable);
+    auto job = new BatchJob(m_gdb, args, m_cores.at(index), m_expressions, m_timeout, this);
+    connect(job, &BatchJob::finished, this, [this, job, index]() { jobFinished(job, index); });
+    m_running++;
+    job->start();
+}
+
+void BatchRunner::jobFinished(BatchJob *job, int index)
+{
+    m_results[index] = job->result();
+    m_failures |= job->result().contains("error");
+    QTextStream err(stderr);
+    err << QFileInfo{job->core()}.fileName() << ": " << job->elapsed() << " ms";
+    if (job->result().contains("error"))
+        err << " (" << job->result().value("error").toString() << ")";
+    err << "\n";
+    m_running--;
+    startNext();
+    if (m_running == 0) {
+        bool written = writeReport();
+        emit finished(!written? 2 : m_failures? 1 : 0);
+    }
+}
+
+bool BatchRunner::writeReport()
+{
+    QJsonArray cores;
+    for (const auto& r: m_results)
+        cores.append(r);
+    QJsonObject report{
+        { "executable", m_executable },
+        { "jobs", m_jobs },
+        { "elapsedMs", double(m_clock.elapsed()) },
+        { "cores", cores },
+    };
+    auto json = QJsonDocument{report}.toJson(QJsonDocument::Indented);
+    QFile out;
+    bool opened;
+    if (m_output.isEmpty() || m_output == "-") {
+        opened = out.open(stdout, QFile::WriteOnly);
+    } else {
+        out.setFileName(m_output);
+        opened = out.open(QFile::WriteOnly | QFile::Truncate);
+    }
+    if (!opened) {
+        QTextStream(stderr) << tr("Cannot write %1").arg(m_output) << "\n";
+        return false;
+    }
+    return out.write(json) == json.size();
+}
@@ -0,0 +1,103 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+class DebugManager;
+class QTimer;
+
+// Post-mortem analysis of one core file in its own gdb instance
+class BatchJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    BatchJob(const QString& gdb, const QStringList& args, const QString& core,
+             const QStringList& expressions, int timeoutSeconds, QObject *parent = nullptr);
+
+    const QString& core() const { return m_core; }
+    const QJsonObject& result() const { return m_result; }
+    qint64 elapsed() const { return m_elapsed; }
+
+public slots:
+    void start();
+
+signals:
+    void finished();
+
+private:
+    using Handler_t = std::function<void (const QVariant& v)>;
+
+    void collect();
+    void collectThread(int id);
+    void evaluate(int thread);
+    void request(const QString& cmd, const Handler_t& handler, const Handler_t& errorHandler = {});
+    void settle();
+    void fail(const QString& msg);
+    void finish();
+
+    DebugManager *m_debug;
+    QTimer *m_timeout;
+    QString m_core;
+    QStringList m_expressions;
+    QElapsedTimer m_clock;
+    QJsonObject m_result;
+    QMap<int, QJsonObject> m_threads;
+    QJsonArray m_errors;
+    QJsonArray m_values;
+    qint64 m_elapsed = 0;
+    int m_pending = 0;
+    bool m_finished = false;
+};
+
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BatchRunner(QObject *parent = nullptr);
+
+    void setGdbCommand(const QString& gdb) { m_gdb = gdb; }
+    void setGdbArgs(const QStringList& args) { m_args = args; }
+    void setExecutable(const QString& exec) { m_executable = exec; }
+    void setCores(const QStringList& cores) { m_cores = cores; }
+    void setExpressions(const QStringList& exprs) { m_expressions = exprs; }
+    void setJobs(int jobs) { m_jobs = qMax(1, jobs); }
+    void setTimeout(int seconds) { m_timeout = seconds; }
+    void setOutput(const QString& path) { m_output = path; }
+
+public slots:
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private:
+    void startNext();
+    void jobFinished(BatchJob *job, int index);
+    bool writeReport();
+
+    QString m_gdb;
+    QStringList m_args;
+    QString m_executable;
+    QStringList m_cores;
+    QStringList m_expressions;
+    QString m_output;
+    int m_jobs = 1;
+    int m_timeout = 120;
+    int m_next = 0;
+    int m_running = 0;
+    bool m_failures = false;
+    QVector<QJsonObject> m_results;
+    QElapsedTimer m_clock;
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,242 @@
+#include "breakpointview.h"
+
+#include <QColor>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QTableView>
+#include <QTimer>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+constexpr int BreakpointModel::UPDATE_INTERVAL;
+constexpr int BreakpointModel::RATE_INTERVAL;
+
+BreakpointModel::BreakpointModel(QObject *parent) :
+    QAbstractTableModel(parent),
+    m_timer(new QTimer(this)),
+    m_rateTimer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(UPDATE_INTERVAL);
+    m_rateTimer->setInterval(RATE_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &BreakpointModel::flush);
+    connect(m_rateTimer, &QTimer::timeout, this, &BreakpointModel::updateRates);
+}
+
+void BreakpointModel::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_rateTimer->stop();
+    beginResetModel();
+    m_rows.clear();
+    m_rowOf.clear();
+    endResetModel();
+    reload();
+    if (!g)
+        return;
+    connect(g, &DebugManager::breakpointHit, this, &BreakpointModel::breakpointHit);
+    connect(g, &DebugManager::resumePauseChanged, this, &BreakpointModel::resumePauseChanged);
+    connect(g, &DebugManager::breakpointInserted, this, &BreakpointModel::scheduleReload);
+    connect(g, &DebugManager::breakpointModified, this, &BreakpointModel::scheduleReload);
+    connect(g, &DebugManager::breakpointRemoved, this, &BreakpointModel::scheduleReload);
+    m_rateClock.start();
+    m_rateTimer->start();
+}
+
+void BreakpointModel::breakpointHit(int bpid, int times)
+{
+    int row = m_rowOf.value(bpid, -1);
+    if (row == -1) {
+        scheduleReload();
+        return;
+    }
+    m_rows[row].bp.times = times;
+    m_dirty.insert(row);
+    schedule();
+}
+
+void BreakpointModel::resumePauseChanged(int bpid)
+{
+    int row = m_rowOf.value(bpid, -1);
+    if (row == -1)
+        return;
+    m_rows[row].pause = m_debug->resumePause(bpid);
+    m_dirty.insert(row);
+    schedule();
+}
+
+void BreakpointModel::scheduleReload()
+{
+    m_reload = true;
+    schedule();
+}
+
+void BreakpointModel::schedule()
+{
+    if (!m_timer->isActive())
+        m_timer->start();
+}
+
+void BreakpointModel::flush()
+{
+    m_timer->stop();
+    if (m_reload) {
+        reload();
+        return;
+    }
+    for (auto row: m_dirty)
+        emit dataChanged(index(row, Hits), index(row, Pause));
+    m_dirty.clear();
+}
+
+void BreakpointModel::reload()
+{
+    m_reload = false;
+    m_dirty.clear();
+    // Keep the rate baseline of breakpoints that survive the reload
+    QHash<int, Row> previous;
+    for (const auto& r: m_rows)
+        previous.insert(r.bp.number, r);
+    beginResetModel();
+    m_rows.clear();
+    m_rowOf.clear();
+    if (m_debug) {
+        for (const auto& bp: m_debug->allBreakpoints()) {
+            auto it = previous.find(bp.number);
+            Row r{ bp, m_debug->resumePause(bp.number), bp.times, 0.0 };
+            if (it != previous.end()) {
+                r.lastTimes = it->lastTimes;
+                r.rate = it->rate;
+            }
+            m_rowOf.insert(bp.number, m_rows.size());
+            m_rows.append(r);
+        }
+    }
+    endResetModel();
+}
+
+void BreakpointModel::updateRates()
+{
+    double seconds = m_rateClock.restart() / 1000.0;
+    if (m_rows.isEmpty() || seconds <= 0)
+        return;
+    for (auto& r: m_rows) {
+        // gdb zeroes hit counts when the program is run again
+        r.rate = qMax(0, r.bp.times - r.lastTimes) / seconds;
+        r.lastTimes = r.bp.times;
+    }
+    emit dataChanged(index(0, Rate), index(m_rows.size() - 1, Rate));
+}
+
+int BreakpointModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid()? 0 : m_rows.size();
+}
+
+int BreakpointModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid()? 0 : COLUMN_COUNT;
+}
+
+QVariant BreakpointModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return {};
+    const auto& r = m_rows.at(index.row());
+    const auto& bp = r.bp;
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case Number: return bp.number;
+        case Location:
+            if (bp.file.isEmpty())
+                return bp.originalLocation;
+            return QString{"%1:%2"}.arg(QFileInfo{bp.file}.fileName()).arg(bp.line);
+        case Condition:
+            if (bp.ignoreCount > 0)
+                return tr("%1 (ignore %2)").arg(bp.condition).arg(bp.ignoreCount).trimmed();
+            return bp.condition;
+        case Hits: return bp.times;
+        case Rate: return r.rate > 0? tr("%1/s").arg(r.rate, 0, 'f', 1) : QString{};
+        case Pause: return r.pause.count? tr("%1 ms").arg(r.pause.averageMs(), 0, 'f', 2) : QString{};
+        }
+    } else if (role == Qt::ToolTipRole) {
+        switch (index.column()) {
+        case Location: return bp.func.isEmpty()? bp.fullname : tr("%1 in %2").arg(bp.func, bp.fullname);
+        case Pause:
+            if (r.pause.count)
+                return tr("%1 automatic resumes, %2 ms in total\nSilent hits (false conditions, dprintf) are not measured")
+                        .arg(r.pause.count).arg(r.pause.totalNs / 1e6, 0, 'f', 1);
+            break;
+        }
+    } else if (role == Qt::ForegroundRole && !bp.enable) {
+        return QColor{Qt::gray};
+    } else if (role == Qt::TextAlignmentRole && index.column() >= Hits) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return {};
+}
+
+QVariant BreakpointModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+    switch (section) {
+    case Number: return tr("#");
+    case Location: return tr("Location");
+    case Condition: return tr("Condition");
+    case Hits: return tr("Hits");
+    case Rate: return tr("Rate");
+    case Pause: return tr("Auto-resume pause");
+    }
+    return {};
+}
+
+BreakpointView::BreakpointView(QWidget *parent) :
+    QWidget(parent),
+    m_model(new BreakpointModel(this)),
+    m_view(new QTableView(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    auto buttonDel = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    buttonDel->setIcon(QIcon{":/images/list-remove.svg"});
+    buttonDel->setToolTip(tr("Remove selected breakpoints"));
+    toolbar->addStretch();
+    toolbar->addWidget(buttonDel);
+    layout->addLayout(toolbar);
+    layout->addWidget(m_view);
+
+    m_view->setModel(m_model);
+    m_view->verticalHeader()->hide();
+    m_view->horizontalHeader()->setSectionResizeMode(BreakpointModel::Location, QHeaderView::Stretch);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    connect(buttonDel, &QToolButton::clicked, this, &BreakpointView::removeSelected);
+    connect(m_view, &QTableView::doubleClicked, [this](const QModelIndex& idx) {
+        emit editRequested(m_model->breakpoint(idx.row()).number);
+    });
+}
+
+void BreakpointView::setDebugManager(DebugManager *g)
+{
+    m_debug = g;
+    m_model->setDebugManager(g);
+}
+
+void BreakpointView::removeSelected()
+{
+    if (!m_debug)
+        return;
+    QList<int> numbers;
+    for (const auto& idx: m_view->selectionModel()->selectedRows())
+        numbers.append(m_model->breakpoint(idx.row()).number);
+    for (auto bpid: numbers)
+        m_debug->breakRemove(bpid);
+}
@@ -0,0 +1,87 @@
+#ifndef BREAKPOINTVIEW_H
+#define BREAKPOINTVIEW_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QWidget>
+
+#include "debugmanager.h"
+
+class QTableView;
+class QTimer;
+
+// Breakpoints with their hit counts. Hits arriving between two UI frames are
+// folded into one dataChanged per row, so dprintf storms cost a repaint per
+// UPDATE_INTERVAL and not one per record
+class BreakpointModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column_t { Number, Location, Condition, Hits, Rate, Pause, COLUMN_COUNT };
+    static constexpr int UPDATE_INTERVAL = 16;
+    static constexpr int RATE_INTERVAL = 1000;
+
+    explicit BreakpointModel(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+    const gdb::Breakpoint& breakpoint(int row) const { return m_rows.at(row).bp; }
+
+    virtual int rowCount(const QModelIndex& parent = {}) const;
+    virtual int columnCount(const QModelIndex& parent = {}) const;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private slots:
+    void breakpointHit(int bpid, int times);
+    void resumePauseChanged(int bpid);
+    void scheduleReload();
+    void flush();
+    void updateRates();
+
+private:
+    struct Row {
+        gdb::Breakpoint bp;
+        DebugManager::ResumePause pause;
+        int lastTimes;
+        double rate;
+    };
+
+    void reload();
+    void schedule();
+
+    DebugManager *m_debug = nullptr;
+    QTimer *m_timer;
+    QTimer *m_rateTimer;
+    QElapsedTimer m_rateClock;
+    QVector<Row> m_rows;
+    QHash<int, int> m_rowOf;    // breakpoint number -> row
+    QSet<int> m_dirty;
+    bool m_reload = false;
+};
+
+class BreakpointView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BreakpointView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+signals:
+    void editRequested(int bpid);
+
+private slots:
+    void removeSelected();
+
+private:
+    DebugManager *m_debug = nullptr;
+    BreakpointModel *m_model;
+    QTableView *m_view;
+};
+
+#endif // BREAKPOINTVIEW_H
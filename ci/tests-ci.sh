@@ -19,6 +19,7 @@ echo ************** LINUX BUILD ***********************
 
 qmake CONFIG+=release CONFIG+=force_debug_info gdbfront.pro
 make -j4
+(cd tests/tst_unescape && qmake tst_unescape.pro && make -j4 && ./tst_unescape)
 make install INSTALL_ROOT=${INSTALL_DIR}
 
 #linuxdeployqt $DESKTOP_FILE $DEPLOY_OPT -appimage
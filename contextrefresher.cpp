@@ -0,0 +1,35 @@
+#include "contextrefresher.h"
+
+#include <QTimer>
+
+constexpr int ContextRefresher::FRAME_INTERVAL;
+constexpr int ContextRefresher::MAX_DELAY;
+constexpr int ContextRefresher::BURST_INTERVAL;
+
+ContextRefresher::ContextRefresher(QObject *parent) :
+    QObject(parent),
+    m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ContextRefresher::refresh);
+}
+
+void ContextRefresher::schedule()
+{
+    if (m_lastStop.isValid() && m_lastStop.elapsed() < BURST_INTERVAL)
+        m_delay = qMin(m_delay * 2, MAX_DELAY);
+    else
+        m_delay = FRAME_INTERVAL;
+    m_lastStop.restart();
+    // Do not push an armed timer: during a long burst the view still follows
+    // the target once per delay, and the refresh always reads the latest stop
+    if (!m_timer->isActive())
+        m_timer->start(m_delay);
+}
+
+void ContextRefresher::cancel()
+{
+    m_timer->stop();
+    m_lastStop.invalidate();
+    m_delay = FRAME_INTERVAL;
+}
@@ -0,0 +1,38 @@
+#ifndef CONTEXTREFRESHER_H
+#define CONTEXTREFRESHER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+
+class QTimer;
+
+// Coalesces context refreshes requested by *stopped records, stretching the
+// delay while stops arrive in bursts (stepping key held, breakpoint storms)
+class ContextRefresher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FRAME_INTERVAL = 16;
+    static constexpr int MAX_DELAY = 250;
+    // Stops closer than this are considered part of a burst
+    static constexpr int BURST_INTERVAL = 100;
+
+    explicit ContextRefresher(QObject *parent = nullptr);
+
+    int delay() const { return m_delay; }
+
+public slots:
+    void schedule();
+    void cancel();
+
+signals:
+    void refresh();
+
+private:
+    QTimer *m_timer;
+    QElapsedTimer m_lastStop;
+    int m_delay = FRAME_INTERVAL;
+};
+
+#endif // CONTEXTREFRESHER_H
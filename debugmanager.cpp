@@ -1,6 +1,12 @@
 #include "debugmanager.h"
+#include "midecoder.h"
+#include "perfstats.h"
+#include "sharedcache.h"
 
+#include <QElapsedTimer>
 #include <QProcess>
+#include <QQueue>
+#include <QSet>
 #include <QVariant>
 #include <QMultiMap>
 #include <QTextCodec>
@@ -34,9 +40,15 @@ constexpr auto EOL = "\n";
 
 QString escapedText(const QString& s)
 {
-    return QString{s}.replace(QRegularExpression{R"(\\(.))"}, "\1");
+    QString v;
+    unescape(s.cbegin(), s.cend(), false, &v);
+    return v;
 }
 
+// Slots of the token ring, tokens in flight at once stay well below this
+constexpr int RESPONSE_SLOTS = 1024;
+constexpr int TOKEN_LIMIT = 999999;
+
 // Partial code is from pygdbmi
 // See on: https://github.com/cs01/pygdbmi/blob/master/pygdbmi/gdbmiparser.py
 
@@ -127,15 +139,7 @@ QString::const_iterator& skipspaces(QString::const_iterator& it)
 QString parseString(const QString& s, QString::const_iterator& it)
 {
     QString v;
-    while (it != s.cend()) {
-        if (*it == '"')
-            break;
-        if (*it == '\\')
-            if (++it == s.cend())
-                break;
-        v += *it++;
-    }
-    ++it;
+    it = mi::unescape(it, s.cend(), true, &v);
     return v;
 }
 
@@ -270,6 +274,100 @@ Response parse_response(const QString& gdb_mi_text)
 
 }
 
+// Record classes and result keys are dispatched by hash, so the case labels
+// are computed at compile time. Duplicate labels do not compile; every switch
+// goes through mi::match() with its label set, which confirms the hit with a
+// string compare, so unknown names never land in a case.
+constexpr quint32 operator"" _mi(const char *s, size_t)
+{
+    return mi::hash(s);
+}
+
+static constexpr mi::Label LIBRARY_KEYS[] = {
+    mi::label("id"), mi::label("target-name"), mi::label("host-name"),
+    mi::label("thread-group"), mi::label("symbols-loaded"), mi::label("ranges"),
+};
+static constexpr mi::Label NOTIFICATIONS[] = {
+    mi::label("stopped"), mi::label("running"), mi::label("breakpoint-modified"),
+    mi::label("breakpoint-created"), mi::label("breakpoint-deleted"), mi::label("memory-changed"),
+};
+static constexpr mi::Label RESULT_CLASSES[] = {
+    mi::label(""), mi::label("done"), mi::label("connected"), mi::label("error"), mi::label("exit"),
+};
+static constexpr mi::Label RESULT_KEYS[] = {
+    mi::label("frame"), mi::label("variables"), mi::label("threads"), mi::label("stack"),
+};
+static constexpr mi::Label THREAD_STATES[] = {
+    mi::label("stopped"), mi::label("running"),
+};
+
+// Fast path for =library-loaded/unloaded storms: takes the fields the library
+// table needs straight from the record text, without building a QVariantMap
+static bool parseLibraryRecord(const QString& line, gdb::Library *lib)
+{
+    int comma = line.indexOf(',');
+    if (comma == -1)
+        return false;
+    auto it = line.cbegin() + comma;
+    auto end = line.cend();
+    while (it != end && *it == ',') {
+        auto key = ++it;
+        while (it != end && *it != '=')
+            ++it;
+        if (it == end || ++it == end)
+            return false;
+        auto keyHash = mi::match(QString::fromRawData(key, int(it - key - 1)), LIBRARY_KEYS);
+        if (*it == '"') {
+            QString value;
+            it = mi::unescape(it + 1, end, true, &value);
+            switch (keyHash) {
+            case "id"_mi: lib->id = value; break;
+            case "target-name"_mi: lib->targetName = value; break;
+            case "host-name"_mi: lib->hostName = value; break;
+            case "thread-group"_mi: lib->threadGroup = value; break;
+            case "symbols-loaded"_mi: lib->symbolsLoaded = value == "1"; break;
+            }
+            continue;
+        }
+        // Lists and tuples, only ranges=[{from="..",to=".."},...] matters
+        auto begin = it;
+        int depth = 0;
+        bool inString = false;
+        for (; it != end; ++it) {
+            auto c = it->unicode();
+            if (inString) {
+                if (c == '\\' && it + 1 != end)
+                    ++it;
+                else if (c == '"')
+                    inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '[' || c == '{') {
+                depth++;
+            } else if ((c == ']' || c == '}') && --depth == 0) {
+                ++it;
+                break;
+            }
+        }
+        if (keyHash == "ranges"_mi) {
+            auto ranges = QString::fromRawData(begin, int(it - begin));
+            auto field = [&ranges](const QString& name) {
+                int at = ranges.indexOf(name);
+                if (at == -1)
+                    return quint64(0);
+                at += name.size();
+                return ranges.mid(at, ranges.indexOf('"', at) - at).toULongLong(nullptr, 16);
+            };
+            lib->from = field("from=\"0x");
+            lib->to = field("to=\"0x");
+        }
+    }
+    return !lib->id.isEmpty();
+}
+
+constexpr int DebugManager::PRIORITY_COUNT;
+constexpr int DebugManager::MAX_IN_FLIGHT;
+
 struct DebugManager::Priv_t
 {
     int tokenCounter = 0;
@@ -278,20 +376,191 @@ struct DebugManager::Priv_t
     struct ResponseEntry {
         DebugManager::ResponseAction_t action;
         DebugManager::ResponseHandler_t handler;
+        DebugManager::ResponseHandler_t errorHandler;
+        bool handlerOnly;
+    };
+
+    struct QueuedCommand {
+        int token;
+        QString cmd;
+        qint64 enqueued;
+    };
+
+    struct ResponseSlot {
+        int token = -1;
+        ResponseEntry entry;
     };
 
-    QHash<int, ResponseEntry> resposeExpected;
+    // Tokens are sequential, so live ones land on distinct slots; only a
+    // request outliving RESPONSE_SLOTS newer ones spills into the overflow
+    ResponseSlot responseSlots[mi::RESPONSE_SLOTS];
+    QHash<int, ResponseEntry> responseOverflow;
+    QQueue<QueuedCommand> queues[DebugManager::PRIORITY_COUNT];
+    DebugManager::QueueStats queueStats[DebugManager::PRIORITY_COUNT];
+    QSet<int> inFlight;
+    QElapsedTimer clock;
+    QHash<int, QPair<qint64, QString>> sentAt;
+    QHash<int, int> contextTokens;
+    QSet<int> cancelledTokens;
+    int stopGeneration = 0;
     bool m_remote = false;
     bool m_inferiorRunning = false;
+    bool m_async = false;
+    bool m_nonStop = false;
+    // Breakpoint edits waiting for the stop requested to apply them
+    QList<std::function<void()>> pausedEdits;
+    bool pausingForEdits = false;
+    bool resumingAfterEdits = false;
+    // Breakpoint the inferior is stopped at, for DebugManager::ResumePause
+    int pauseBreakpoint = -1;
+    qint64 pauseStartNs = 0;
+    bool resumeRequested = false;
+    // Console text of -interpreter-exec queries while any is in flight
+    int consoleCaptures = 0;
+    QString consoleCapture;
+    QHash<int, DebugManager::ResumePause> resumePauses;
     std::atomic_bool m_firstPromt{true};
     QMap<int, gdb::Breakpoint> breakpoints;
     QMap<QString, gdb::Variable> varsWatched;
+    QVector<gdb::Library> libraries;
+    QHash<QString, int> libraryIndex;
+    int libraryRecordsUnlogged = 0;
+    // Last =breakpoint-modified of each breakpoint, split around times="N"
+    struct HitRecord {
+        QString head;
+        QString tail;
+    };
+    QHash<int, HitRecord> hitRecords;
+    int hitRecordsUnlogged = 0;
 #ifdef Q_OS_WIN
     QString m_sigintHelperCmd;
 #endif
 
     Priv_t(DebugManager *self) : gdb(new QProcess(self))
     {
+        clock.start();
+    }
+
+    // Records without a token parse as -1 and never have a handler
+    ResponseEntry *findResponse(int token)
+    {
+        if (token < 0)
+            return nullptr;
+        auto& slot = responseSlots[token % mi::RESPONSE_SLOTS];
+        if (slot.token == token)
+            return &slot.entry;
+        if (responseOverflow.isEmpty())
+            return nullptr;
+        auto it = responseOverflow.find(token);
+        return it == responseOverflow.end()? nullptr : &it.value();
+    }
+
+    void insertResponse(int token, const ResponseEntry& e)
+    {
+        if (token < 0)
+            return;
+        auto& slot = responseSlots[token % mi::RESPONSE_SLOTS];
+        if (slot.token == -1 || slot.token == token) {
+            slot.token = token;
+            slot.entry = e;
+        } else {
+            responseOverflow.insert(token, e);
+        }
+    }
+
+    void removeResponse(int token)
+    {
+        if (token < 0)
+            return;
+        auto& slot = responseSlots[token % mi::RESPONSE_SLOTS];
+        if (slot.token == token) {
+            slot.token = -1;
+            slot.entry = {};
+        } else if (!responseOverflow.isEmpty()) {
+            responseOverflow.remove(token);
+        }
+    }
+
+    // Hands out the handlers for token, releasing the entry if it is temporal
+    bool takeResponse(int token, DebugManager::ResponseHandler_t *handler,
+                      DebugManager::ResponseHandler_t *errorHandler)
+    {
+        auto e = findResponse(token);
+        if (!e)
+            return false;
+        bool temporal = e->action == DebugManager::ResponseAction_t::Temporal;
+        if (handler)
+            *handler = temporal? std::move(e->handler) : e->handler;
+        if (errorHandler)
+            *errorHandler = temporal? std::move(e->errorHandler) : e->errorHandler;
+        if (temporal)
+            removeResponse(token);
+        return true;
+    }
+
+    void clearResponses()
+    {
+        for (auto& slot: responseSlots) {
+            slot.token = -1;
+            slot.entry = {};
+        }
+        responseOverflow.clear();
+    }
+
+    int nextToken()
+    {
+        // After wrapping around skip tokens that are still waiting for an answer
+        int token;
+        do {
+            token = tokenCounter;
+            tokenCounter = (tokenCounter + 1) % mi::TOKEN_LIMIT;
+        } while (findResponse(token) || inFlight.contains(token) || cancelledTokens.contains(token));
+        return token;
+    }
+
+    bool removeQueued(int token)
+    {
+        for (int p = 0; p < DebugManager::PRIORITY_COUNT; p++) {
+            for (int i = 0; i < queues[p].size(); i++) {
+                if (queues[p].at(i).token == token) {
+                    queues[p].removeAt(i);
+                    queueStats[p].dropped++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void resetQueues()
+    {
+        for (auto& q: queues)
+            q.clear();
+        inFlight.clear();
+    }
+
+    // Returns the error handlers of the dropped requests, the caller runs them
+    // once the queues are consistent again
+    QList<DebugManager::ResponseHandler_t> newStopGeneration()
+    {
+        QList<DebugManager::ResponseHandler_t> dropped;
+        DebugManager::ResponseHandler_t errorHandler;
+        // Context queries issued before this point describe a stale state
+        stopGeneration++;
+        for (auto it = contextTokens.cbegin(); it != contextTokens.cend(); ++it) {
+            if (takeResponse(it.key(), nullptr, &errorHandler) && errorHandler)
+                dropped.append(std::move(errorHandler));
+            if (!removeQueued(it.key()))
+                cancelledTokens.insert(it.key());
+        }
+        contextTokens.clear();
+        auto& background = queues[int(DebugManager::Priority_t::Background)];
+        for (const auto& e: background)
+            if (takeResponse(e.token, nullptr, &errorHandler) && errorHandler)
+                dropped.append(std::move(errorHandler));
+        queueStats[int(DebugManager::Priority_t::Background)].dropped += quint64(background.size());
+        background.clear();
+        return dropped;
     }
 };
 
@@ -309,12 +578,6 @@ void registerMetatypes() {
 }
 }
 
-template<typename Tret>
-static Tret strmap(const QMap<QString, Tret>& map, const QString& key, Tret def)
-{
-    return map.value(key, def);
-}
-
 DebugManager::DebugManager(QObject *parent) :
     QObject(parent),
     self(new Priv_t{this})
@@ -325,7 +588,10 @@ DebugManager::DebugManager(QObject *parent) :
     setSigintHelperCmd(mi::DEFAULT_SIGINT_HELPER);
 #endif
     connect(self->gdb, &QProcess::readyReadStandardOutput, [this]() {
-        for (const auto& c: QString{self->gdb->readAllStandardOutput()})
+        PERF_SCOPE("DebugManager::read");
+        auto data = self->gdb->readAllStandardOutput();
+        perf::count("mi.bytes", data.size());
+        for (const auto& c: QString{data})
             switch (c.toLatin1()) {
             case '\r': break;
             case '\n':
@@ -339,9 +605,27 @@ DebugManager::DebugManager(QObject *parent) :
         emit gdbProcessStarted();
         self->tokenCounter = 0;
         self->buffer.clear();
-        self->resposeExpected.clear();
+        self->clearResponses();
+        self->contextTokens.clear();
+        self->cancelledTokens.clear();
+        self->resetQueues();
+        self->sentAt.clear();
         self->varsWatched.clear();;
+        self->libraries.clear();
+        self->libraryIndex.clear();
+        self->libraryRecordsUnlogged = 0;
+        self->hitRecords.clear();
+        self->hitRecordsUnlogged = 0;
         self->m_remote = false;
+        self->m_async = false;
+        self->m_nonStop = false;
+        self->pausedEdits.clear();
+        self->pausingForEdits = false;
+        self->resumingAfterEdits = false;
+        self->pauseBreakpoint = -1;
+        self->consoleCaptures = 0;
+        self->consoleCapture.clear();
+        self->resumePauses.clear();
         self->m_firstPromt.store(true);
     });
     connect(self->gdb, QOverload<int>::of(&QProcess::finished),
@@ -376,6 +660,21 @@ bool DebugManager::isGdbExecuting() const
     return self->gdb->state() != QProcess::NotRunning;
 }
 
+bool DebugManager::isAsync() const
+{
+    return self->m_async;
+}
+
+bool DebugManager::isNonStop() const
+{
+    return self->m_nonStop;
+}
+
+bool DebugManager::isReady() const
+{
+    return self->gdb->state() == QProcess::Running && !self->m_firstPromt.load();
+}
+
 QList<gdb::Breakpoint> DebugManager::allBreakpoints() const
 {
     return self->breakpoints.values();
@@ -412,6 +711,23 @@ bool DebugManager::isInferiorRunning() const
     return self->m_inferiorRunning;
 }
 
+int DebugManager::stopGeneration() const
+{
+    return self->stopGeneration;
+}
+
+DebugManager::QueueStats DebugManager::queueStats(Priority_t priority) const
+{
+    auto stats = self->queueStats[int(priority)];
+    stats.depth = self->queues[int(priority)].size();
+    return stats;
+}
+
+int DebugManager::commandsInFlight() const
+{
+    return self->inFlight.size();
+}
+
 #ifdef Q_OS_WIN
 QString DebugManager::sigintHelperCmd() const
 {
@@ -427,6 +743,9 @@ QStringList DebugManager::gdbArgs() const
 void DebugManager::execute()
 {
     auto a = self->gdb->arguments();
+    // Set before any -x script gets to run the inferior
+    a.prepend("set mi-async on");
+    a.prepend("-iex");
     a.prepend("-interpreter=mi");
     self->gdb->setArguments(a);
     self->gdb->setProgram(gdbCommand());
@@ -440,42 +759,212 @@ void DebugManager::quit()
 
 void DebugManager::command(const QString &cmd)
 {
-    auto tokStr = QString{"%1"}.arg(self->tokenCounter, 6, 10, QChar{'0'});
-    auto line = QString{"%1%2%3"}.arg(tokStr, cmd, mi::EOL);
-    self->tokenCounter = (self->tokenCounter + 1) % 999999;
-    self->gdb->write(line.toLocal8Bit());
-    QString sOut;
-    QTextStream(&sOut) << "gdbCommand: " << line << "\n";
-    emit streamDebugInternal(sOut);
+    enqueue(cmd, Priority_t::Interactive);
+}
+
+void DebugManager::userCommand(const QString &cmd)
+{
+    // Anything typed may resume the inferior (continue, next, call...)
+    resumeCommand(cmd);
+}
+
+void DebugManager::resumeCommand(const QString &cmd)
+{
+    // Interactive commands are written at once, so the flag precedes the
+    // *running they cause
+    self->resumeRequested = true;
+    command(cmd);
 }
 
 void DebugManager::commandAndResponse(const QString& cmd,
                                       const ResponseHandler_t& handler,
                                       ResponseAction_t action)
 {
-    self->resposeExpected.insert(self->tokenCounter, { action, handler });
-    command(cmd);
+    int token = enqueue(cmd, Priority_t::Interactive);
+    self->insertResponse(token, { action, handler, {}, false });
+}
+
+void DebugManager::commandAndResponse(const QString &cmd,
+                                      const ResponseHandler_t &handler,
+                                      const ResponseHandler_t &errorHandler)
+{
+    enqueue(cmd, Priority_t::Interactive, handler, errorHandler);
+}
+
+int DebugManager::enqueue(const QString &cmd, Priority_t priority,
+                          const ResponseHandler_t &handler,
+                          const ResponseHandler_t &errorHandler,
+                          Delivery_t delivery)
+{
+    // The token is fixed here so the request can be cancelled while queued
+    int token = self->nextToken();
+    if (handler || errorHandler)
+        self->insertResponse(token, { ResponseAction_t::Temporal, handler, errorHandler,
+                                      delivery == Delivery_t::HandlerOnly });
+    self->queues[int(priority)].enqueue({ token, cmd, self->clock.elapsed() });
+    dispatchQueued();
+    return token;
+}
+
+void DebugManager::dispatchQueued()
+{
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+        auto& queue = self->queues[p];
+        bool interactive = p == int(Priority_t::Interactive);
+        while (!queue.isEmpty() && (interactive || self->inFlight.size() < MAX_IN_FLIGHT)) {
+            auto e = queue.dequeue();
+            auto& stats = self->queueStats[p];
+            auto wait = self->clock.elapsed() - e.enqueued;
+            stats.sent++;
+            stats.totalWaitMs += wait;
+            stats.maxWaitMs = qMax(stats.maxWaitMs, wait);
+            // User commands may never be answered (console CLI, gdb busy), so
+            // only the bounded classes take a slot
+            if (!interactive)
+                self->inFlight.insert(e.token);
+            if (perf::enabled)
+                self->sentAt.insert(e.token, { perf::Stats::instance()->now(), e.cmd.section(' ', 0, 0) });
+            auto tokStr = QString{"%1"}.arg(e.token, 6, 10, QChar{'0'});
+            auto line = QString{"%1%2%3"}.arg(tokStr, e.cmd, mi::EOL);
+            self->gdb->write(line.toLocal8Bit());
+            QString sOut;
+            QTextStream(&sOut) << "gdbCommand: " << line << "\n";
+            emit streamDebugInternal(sOut);
+        }
+        if (!queue.isEmpty())
+            break;
+    }
+}
+
+int DebugManager::contextCommand(const QString &cmd, const ResponseHandler_t &handler)
+{
+    int token = enqueue(cmd, Priority_t::Refresh, handler);
+    self->contextTokens.insert(token, self->stopGeneration);
+    return token;
+}
+
+void DebugManager::newStopGeneration()
+{
+    // Every enqueued request completes once, dropped ones through their error handler
+    const QVariantMap payload{ { "msg", tr("Cancelled by a target state change") }, { "cancelled", true } };
+    for (const auto& errorHandler: self->newStopGeneration())
+        errorHandler(payload);
+}
+
+bool DebugManager::isCancelled(const QVariant &error)
+{
+    return error.toMap().value("cancelled").toBool();
+}
+
+void DebugManager::cancel(int token)
+{
+    self->removeResponse(token);
+    self->contextTokens.remove(token);
+    if (!self->removeQueued(token))
+        self->cancelledTokens.insert(token);
 }
 
 void DebugManager::breakRemove(int bpid)
 {
-    commandAndResponse(QString{"-break-delete %1"}.arg(bpid), [this, bpid](const QVariant&) {
-        auto bp = self->breakpoints.value(bpid);
-        self->breakpoints.remove(bpid);
-        emit breakpointRemoved(bp);
+    whileStopped([this, bpid]() {
+        commandAndResponse(QString{"-break-delete %1"}.arg(bpid), [this, bpid](const QVariant&) {
+            auto bp = self->breakpoints.value(bpid);
+            self->breakpoints.remove(bpid);
+            emit breakpointRemoved(bp);
+        });
     });
 }
 
 void DebugManager::breakInsert(const QString &path)
 {
-    commandAndResponse(QString{"-break-insert %1"}.arg(path), [this](const QVariant& r) {
-        auto data = r.toMap();
-        auto bp = gdb::Breakpoint::parseMap(data.value("bkpt").toMap());
+    whileStopped([this, path]() {
+        commandAndResponse(QString{"-break-insert %1"}.arg(path), [this](const QVariant& r) {
+            auto data = r.toMap();
+            auto bp = gdb::Breakpoint::parseMap(data.value("bkpt").toMap());
+            self->breakpoints.insert(bp.number, bp);
+            emit breakpointInserted(bp);
+        });
+    });
+}
+
+void DebugManager::breakCondition(int bpid, const QString &condition)
+{
+    auto cmd = QString{"-break-condition %1"}.arg(bpid);
+    if (!condition.isEmpty())
+        cmd += ' ' + condition;
+    whileStopped([this, bpid, cmd]() {
+        commandAndResponse(cmd, [this, bpid](const QVariant&) { breakRefresh(bpid); });
+    });
+}
+
+void DebugManager::breakAfter(int bpid, int count)
+{
+    whileStopped([this, bpid, count]() {
+        commandAndResponse(QString{"-break-after %1 %2"}.arg(bpid).arg(count),
+                           [this, bpid](const QVariant&) { breakRefresh(bpid); });
+    });
+}
+
+void DebugManager::whileStopped(const std::function<void()> &edit)
+{
+    if (!self->m_inferiorRunning || self->m_nonStop) {
+        edit();
+        return;
+    }
+    // gdb runs all-stop and refuses breakpoint changes while the inferior runs
+    self->pausedEdits.append(edit);
+    if (!self->pausingForEdits) {
+        self->pausingForEdits = true;
+        commandInterrupt();
+    }
+}
+
+void DebugManager::breakRefresh(int bpid)
+{
+    // gdb sends no =breakpoint-modified for changes made through MI itself
+    commandAndResponse(QString{"-break-info %1"}.arg(bpid), [this](const QVariant& r) {
+        auto body = r.toMap().value("BreakpointTable").toMap().value("body").toList();
+        if (body.isEmpty())
+            return;
+        auto bp = gdb::Breakpoint::parseMap(body.first().toMap().value("bkpt").toMap());
+        if (!bp.isValid())
+            return;
         self->breakpoints.insert(bp.number, bp);
-        emit breakpointInserted(bp);
+        emit breakpointModified(bp);
     });
 }
 
+void DebugManager::setConditionEvaluation(const QString &mode)
+{
+    command(QString{"-gdb-set breakpoint condition-evaluation %1"}.arg(mode));
+}
+
+void DebugManager::queryTargetConditions(const std::function<void(bool)> &handler)
+{
+    if (!self->m_remote) {
+        handler(false);
+        return;
+    }
+    // The support is only printed, -gdb-show answers the "auto" setting
+    auto done = [this, handler](bool ok) {
+        bool enabled = ok && self->consoleCapture.contains(QLatin1String("ConditionalBreakpoints")) &&
+                self->consoleCapture.contains(QLatin1String("currently enabled"));
+        if (--self->consoleCaptures == 0)
+            self->consoleCapture.clear();
+        handler(enabled);
+    };
+    // Interactive commands are written at once, the capture starts with it
+    self->consoleCaptures++;
+    commandAndResponse("-interpreter-exec console \"show remote conditional-breakpoints-packet\"",
+                       [done](const QVariant&) { done(true); },
+                       [done](const QVariant&) { done(false); });
+}
+
+DebugManager::ResumePause DebugManager::resumePause(int bpid) const
+{
+    return self->resumePauses.value(bpid);
+}
+
 void DebugManager::loadExecutable(const QString &file)
 {
     command(QString{"-file-exec-and-symbols %1",}.arg(file));
@@ -483,7 +972,7 @@ void DebugManager::loadExecutable(const QString &file)
 
 void DebugManager::launchLocal()
 {
-    command("-exec-run");
+    resumeCommand("-exec-run");
     self->m_remote = false;
 }
 
@@ -495,26 +984,42 @@ void DebugManager::launchRemote(const QString &remoteTarget)
 
 void DebugManager::commandContinue()
 {
-    command("-exec-continue");
+    // Without --all a non-stop gdb resumes only the selected thread
+    resumeCommand(self->m_nonStop? "-exec-continue --all" : "-exec-continue");
 }
 
 void DebugManager::commandNext()
 {
-    command("-exec-next");
+    resumeCommand("-exec-next");
 }
 
 void DebugManager::commandStep()
 {
-    command("-exec-step");
+    resumeCommand("-exec-step");
 }
 
 void DebugManager::commandFinish()
 {
-    command("-exec-finish");
+    resumeCommand("-exec-finish");
+}
+
+void DebugManager::commandNextInstruction()
+{
+    resumeCommand("-exec-next-instruction");
+}
+
+void DebugManager::commandStepInstruction()
+{
+    resumeCommand("-exec-step-instruction");
 }
 
-void DebugManager::commandInterrupt()
+void DebugManager::commandInterrupt(int thread)
 {
+    if (self->m_async) {
+        command(thread == -1? QString{"-exec-interrupt --all"} : QString{"-exec-interrupt --thread %1"}.arg(thread));
+        return;
+    }
+    // Synchronous gdb does not read commands while the inferior runs
 #ifdef Q_OS_WIN
     auto pid = self->gdb->processId();
     auto cmd = sigintHelperCmd().arg(pid);
@@ -546,7 +1051,8 @@ void DebugManager::traceDelVariable(const QString &name)
 
 void DebugManager::traceUpdateVariable(const QString &name)
 {
-    commandAndResponse(QString{"-var-update --all-values %1"}.arg(name), [this](const QVariant& r) {
+    auto cmd = QString{"-var-update --all-values %1"}.arg(name);
+    enqueue(cmd, Priority_t::Refresh, [this](const QVariant& r) {
         auto changeList = r.toMap().value("changelist").toList();
         QStringList changedNames;
         for(const auto& e: changeList) {
@@ -588,115 +1094,204 @@ void DebugManager::setSigintHelperCmd(QString sigintHelperCmd)
 
 void DebugManager::processLine(const QString &line)
 {
-    using dispatcher_t = std::function<void(const mi::Response&)>;
-
-    auto r = mi::parse_response(line);
+    PERF_SCOPE("DebugManager::processLine");
+    perf::count("mi.lines");
+    if (line.startsWith(QLatin1String("=library-"))) {
+        processLibraryRecord(line);
+        return;
+    }
+    if (line.startsWith(QLatin1String("=breakpoint-modified,")) && processHitRecord(line))
+        return;
+    if (self->libraryRecordsUnlogged) {
+        emit streamDebugInternal(QString{"gdbResponse: (%1 =library records)\n"}.arg(self->libraryRecordsUnlogged));
+        self->libraryRecordsUnlogged = 0;
+    }
+    if (self->hitRecordsUnlogged) {
+        emit streamDebugInternal(QString{"gdbResponse: (%1 hit count records)\n"}.arg(self->hitRecordsUnlogged));
+        self->hitRecordsUnlogged = 0;
+    }
+    mi::Response r;
+    {
+        PERF_SCOPE("mi::parse_response");
+        r = mi::parse_response(line);
+    }
 
     QString sOut;
     QTextStream(&sOut) << "gdbResponse: " << line << "\n";
     emit streamDebugInternal(sOut);
 
+    PERF_SCOPE("DebugManager::dispatch");
     switch (r.type) {
-    case mi::Response::notify:
-        static const QMap<QString, dispatcher_t> responseDispatcher{
-            { "stopped", [this](const mi::Response& r) {
-                auto data = r.payload.toMap();
-                gdb::AsyncContext ctx;
-                ctx.reason = gdb::AsyncContext::textToReason(data.value("reason").toString());
-                ctx.threadId = data.value("thread-id").toString();
-                ctx.core = data.value("core").toInt();
-                ctx.frame = gdb::Frame::parseMap(data.value("frame").toMap());
-                self->m_inferiorRunning = false;
-                emit asyncStopped(ctx);
-             } },
-             { "running", [this](const mi::Response& r) {
-                 auto data = r.payload.toMap();
-                 auto thid = data.value("thread-id").toString();
-                 self->m_inferiorRunning = true;
-                 emit asyncRunning(thid);
-             } },
-            { "breakpoint-modified", [this](const mi::Response& r) {
-                 auto data = r.payload.toMap();
-                 auto bp = gdb::Breakpoint::parseMap(data.value("bkpt").toMap());
-                 self->breakpoints.insert(bp.number, bp);
-                 emit breakpointModified(bp);
-             } },
-            { "breakpoint-created", [this](const mi::Response& r) {
-                 auto data = r.payload.toMap();
-                 auto bp = gdb::Breakpoint::parseMap(data.value("bkpt").toMap());
-                 self->breakpoints.insert(bp.number, bp);
-                 emit breakpointModified(bp);
-             } },
-            { "breakpoint-deleted", [this](const mi::Response& r) {
-                 auto data = r.payload.toMap();
-                 auto id = data.value("id").toInt();
-                 auto bp = self->breakpoints.value(id);
-                 self->breakpoints.remove(id);
-                 emit breakpointRemoved(bp);
-             } },
-        };
-        responseDispatcher.value(r.message, [](const mi::Response&){})(r);
+    case mi::Response::notify: {
+        auto data = r.payload.toMap();
+        switch (mi::match(r.message, NOTIFICATIONS)) {
+        case "stopped"_mi: {
+            gdb::AsyncContext ctx;
+            ctx.reason = gdb::AsyncContext::textToReason(data.value("reason").toString());
+            ctx.threadId = data.value("thread-id").toString();
+            ctx.core = data.value("core").toInt();
+            ctx.frame = gdb::Frame::parseMap(data.value("frame").toMap());
+            if (data.contains("bkptno"))
+                ctx.bkptno = data.value("bkptno").toInt();
+            if (self->pausingForEdits) {
+                self->pausingForEdits = false;
+                auto edits = self->pausedEdits;
+                self->pausedEdits.clear();
+                for (const auto& edit: edits)
+                    edit();
+                // Our own interrupt reports SIGINT, or "0" from -exec-interrupt on
+                // some targets; anything else is a real stop the views must see
+                auto signal = data.value("signal-name").toString();
+                if ((ctx.reason == gdb::AsyncContext::Reason::signalReceived ||
+                        ctx.reason == gdb::AsyncContext::Reason::Unknown) &&
+                        (signal == "SIGINT" || signal == "0")) {
+                    self->resumingAfterEdits = true;
+                    command("-exec-continue");
+                    break;
+                }
+            }
+            self->pauseBreakpoint = ctx.reason == gdb::AsyncContext::Reason::breakpointHhit? ctx.bkptno : -1;
+            self->pauseStartNs = self->clock.nsecsElapsed();
+            self->resumeRequested = false;
+            self->m_inferiorRunning = false;
+            newStopGeneration();
+            emit asyncStopped(ctx);
+            break;
+        }
+        case "running"_mi: {
+            auto thid = data.value("thread-id").toString();
+            if (self->resumingAfterEdits) {
+                self->resumingAfterEdits = false;
+                break;
+            }
+            if (self->pauseBreakpoint != -1 && !self->resumeRequested) {
+                auto& pause = self->resumePauses[self->pauseBreakpoint];
+                pause.count++;
+                pause.totalNs += self->clock.nsecsElapsed() - self->pauseStartNs;
+                emit resumePauseChanged(self->pauseBreakpoint);
+            }
+            self->pauseBreakpoint = -1;
+            self->m_inferiorRunning = true;
+            newStopGeneration();
+            emit asyncRunning(thid);
+            break;
+        }
+        case "breakpoint-modified"_mi:
+        case "breakpoint-created"_mi: {
+            auto bp = gdb::Breakpoint::parseMap(data.value("bkpt").toMap());
+            self->breakpoints.insert(bp.number, bp);
+            emit breakpointModified(bp);
+            break;
+        }
+        case "breakpoint-deleted"_mi: {
+            auto id = data.value("id").toInt();
+            auto bp = self->breakpoints.value(id);
+            self->breakpoints.remove(id);
+            self->resumePauses.remove(id);
+            self->hitRecords.remove(id);
+            emit breakpointRemoved(bp);
+            break;
+        }
+        case "memory-changed"_mi: {
+            auto addr = data.value("addr").toString().toULongLong(nullptr, 16);
+            auto len = data.value("len").toString().toULongLong(nullptr, 16);
+            emit memoryChanged(addr, len);
+            break;
+        }
+        }
         break;
+    }
     case mi::Response::result:
-        if (r.message == "done" || r.message == "") {
-            static const QMap<QString, dispatcher_t> doneDispatcher{
-                { "frame", [this](const mi::Response& r) {
-                     auto f = gdb::Frame::parseMap(r.payload.toMap().value("frame").toMap());
-                     emit updateCurrentFrame(f);
-                 }},
-                { "variables", [this](const mi::Response& r) {
-                     QList<gdb::Variable> variableList;
-                     auto locals = r.payload.toMap().value("variables").toList();
-                     for (const auto& e: locals)
-                         variableList.append(gdb::Variable::parseMap(e.toMap()));
-                     emit updateLocalVariables(variableList);
-                 }},
-                { "threads", [this](const mi::Response& r) {
-                     QList<gdb::Thread> threadList;
-                     auto data =  r.payload.toMap();
-                     auto threads = data.value("threads").toList();
-                     auto currId = data.value("current-thread-id").toInt();
-                     for (const auto& e: threads)
-                         threadList.append(gdb::Thread::parseMap(e.toMap()));
-                     emit updateThreads(currId, threadList);
-                 }},
-                { "stack", [this](const mi::Response& r) {
-                     QList<gdb::Frame> stackFrames;
-                     auto stackTrace = r.payload.toMap().value("stack").toList().first().toMap().values("frame");
-                     for (const auto& e: stackTrace) {
-                         auto frame = gdb::Frame::parseMap(e.toMap());
-                         stackFrames.append(frame);
-                     }
-                     emit updateStackFrame(stackFrames);
-                 }},
-            };
-            for (const auto& k: r.payload.toMap().keys())
-                doneDispatcher.value(k, [](const mi::Response&){})(r);
-            if (self->resposeExpected.contains(r.token)) {
-                auto& e = self->resposeExpected.value(r.token);
-                e.handler(r.payload);
-                if (e.action == DebugManager::ResponseAction_t::Temporal)
-                    self->resposeExpected.remove(r.token);
+        if (!self->sentAt.isEmpty() && self->sentAt.contains(r.token)) {
+            auto sent = self->sentAt.take(r.token);
+            auto s = perf::Stats::instance();
+            s->addAsync(sent.second, r.token, sent.first, s->now() - sent.first);
+        }
+        if (self->inFlight.remove(r.token))
+            dispatchQueued();
+        if (!self->contextTokens.isEmpty())
+            self->contextTokens.remove(r.token);
+        if (!self->cancelledTokens.isEmpty() && self->cancelledTokens.remove(r.token))
+            break;
+        switch (mi::match(r.message, RESULT_CLASSES)) {
+        case ""_mi:
+        case "done"_mi: {
+            auto data = r.payload.toMap();
+            auto entry = self->findResponse(r.token);
+            bool broadcast = !entry || !entry->handlerOnly;
+            for (auto it = data.cbegin(); broadcast && it != data.cend(); ++it) {
+                switch (mi::match(it.key(), RESULT_KEYS)) {
+                case "frame"_mi:
+                    emit updateCurrentFrame(gdb::Frame::parseMap(it.value().toMap()));
+                    break;
+                case "variables"_mi: {
+                    QList<gdb::Variable> variableList;
+                    for (const auto& e: it.value().toList())
+                        variableList.append(gdb::Variable::parseMap(e.toMap()));
+                    emit updateLocalVariables(variableList);
+                    break;
+                }
+                case "threads"_mi: {
+                    QList<gdb::Thread> threadList;
+                    auto currId = data.value("current-thread-id").toInt();
+                    for (const auto& e: it.value().toList())
+                        threadList.append(gdb::Thread::parseMap(e.toMap()));
+                    emit updateThreads(currId, threadList);
+                    break;
+                }
+                case "stack"_mi: {
+                    QList<gdb::Frame> stackFrames;
+                    auto stackTrace = it.value().toList().first().toMap().values("frame");
+                    for (const auto& e: stackTrace)
+                        stackFrames.append(gdb::Frame::parseMap(e.toMap()));
+                    emit updateStackFrame(stackFrames);
+                    break;
+                }
+                }
             }
-        } else if (r.message == "connected") {
+            DebugManager::ResponseHandler_t handler;
+            if (self->takeResponse(r.token, &handler, nullptr) && handler)
+                handler(r.payload);
+            break;
+        }
+        case "connected"_mi:
             self->m_remote = true;
             emit targetRemoteConnected();
-        } else if (r.message == "error") {
-            emit gdbError(mi::escapedText(r.payload.toMap().value("msg").toString()));
-        } else if (r.message == "exit") {
+            break;
+        case "error"_mi: {
+            DebugManager::ResponseHandler_t errorHandler;
+            self->takeResponse(r.token, nullptr, &errorHandler);
+            if (errorHandler)
+                errorHandler(r.payload);
+            else
+                emit gdbError(r.payload.toMap().value("msg").toString());
+            break;
+        }
+        case "exit"_mi:
             self->m_remote = false;
             self->m_firstPromt.store(false);
             emit terminated();
+            break;
         }
         emit result(r.token, r.message, r.payload);
         break;
     case mi::Response::console:
     case mi::Response::target:
+        if (self->consoleCaptures > 0)
+            self->consoleCapture += mi::escapedText(r.message);
         emit streamConsole(mi::escapedText(r.message));
         break;
     case mi::Response::promt:
-        if (self->m_firstPromt.exchange(false))
+        if (self->m_firstPromt.exchange(false)) {
+            // gdb before 7.8 has no mi-async, interrupts then go through SIGINT
+            enqueue("-gdb-show mi-async", Priority_t::Interactive, [this](const QVariant& r) {
+                self->m_async = r.toMap().value("value").toString() == "on";
+            });
+            enqueue("-gdb-show non-stop", Priority_t::Interactive, [this](const QVariant& r) {
+                self->m_nonStop = r.toMap().value("value").toString() == "on";
+            });
             emit started();
+        }
         emit gdbPromt();
         break;
     case mi::Response::log:
@@ -707,64 +1302,186 @@ void DebugManager::processLine(const QString &line)
     }
 }
 
-gdb::Frame gdb::Frame::parseMap(const QVariantMap &data)
+// Function, file and type names repeat in every stop of every session
+static void interned(QString& out, const QVariant& v)
 {
-    gdb::Frame f;
-    f.level = data.value("level").toInt();
-    f.addr = data.value("addr").toString().toULongLong(nullptr, 16);
-    f.func = data.value("func").toString();
-    f.file = data.value("file").toString();
-    auto args = data.value("args").toMap();
+    out = SharedCache::instance()->intern(v.toString());
+}
+
+static void frameArgs(QHash<QString, QString>& out, const QVariant& v)
+{
+    auto args = v.toMap();
     for (auto it = args.cbegin(); it != args.cend(); ++it)
-        f.params.insert(it.key(), it.value().toString());
-    f.fullpath = data.value("fullname").toString();
-    f.line = data.value("line").toInt();
-    return f;
+        out.insert(it.key(), it.value().toString());
+}
+
+static void breakpointDisp(gdb::Breakpoint::Disp_t& out, const QVariant& v)
+{
+    out = v.toString() == "del"? gdb::Breakpoint::del : gdb::Breakpoint::keep;
+}
+
+static void breakpointEnable(bool& out, const QVariant& v)
+{
+    out = v.toString() != "n";
+}
+
+static void threadState(gdb::Thread::State_t& out, const QVariant& v)
+{
+    switch (mi::match(v.toString(), THREAD_STATES)) {
+    case "stopped"_mi: out = gdb::Thread::Stopped; break;
+    case "running"_mi: out = gdb::Thread::Running; break;
+    default: out = gdb::Thread::Unknown; break;
+    }
+}
+
+static void threadFrame(gdb::Frame& out, const QVariant& v)
+{
+    out = gdb::Frame::parseMap(v.toMap());
+}
+
+constexpr mi::Field<gdb::Frame> FRAME_FIELDS[] = {
+    MI_FIELD(gdb::Frame, level, "level"),
+    MI_FIELD_WITH(gdb::Frame, addr, "addr", mi::hexAddress),
+    MI_FIELD_WITH(gdb::Frame, func, "func", interned),
+    MI_FIELD_WITH(gdb::Frame, file, "file", interned),
+    MI_FIELD_WITH(gdb::Frame, params, "args", frameArgs),
+    MI_FIELD_WITH(gdb::Frame, fullpath, "fullname", interned),
+    MI_FIELD(gdb::Frame, line, "line"),
+};
+
+constexpr mi::Field<gdb::Breakpoint> BREAKPOINT_FIELDS[] = {
+    MI_FIELD(gdb::Breakpoint, number, "number"),
+    MI_FIELD(gdb::Breakpoint, type, "type"),
+    MI_FIELD_WITH(gdb::Breakpoint, disp, "disp", breakpointDisp),
+    MI_FIELD_WITH(gdb::Breakpoint, enable, "enable", breakpointEnable),
+    MI_FIELD_WITH(gdb::Breakpoint, addr, "addr", mi::hexAddress),
+    MI_FIELD_WITH(gdb::Breakpoint, func, "func", interned),
+    MI_FIELD_WITH(gdb::Breakpoint, file, "file", interned),
+    MI_FIELD_WITH(gdb::Breakpoint, fullname, "fullname", interned),
+    MI_FIELD(gdb::Breakpoint, line, "line"),
+    MI_FIELD(gdb::Breakpoint, threadGroups, "thread-groups"),
+    MI_FIELD(gdb::Breakpoint, times, "times"),
+    MI_FIELD(gdb::Breakpoint, originalLocation, "original-location"),
+    MI_FIELD(gdb::Breakpoint, condition, "cond"),
+    MI_FIELD(gdb::Breakpoint, ignoreCount, "ignore"),
+};
+
+constexpr mi::Field<gdb::Variable> VARIABLE_FIELDS[] = {
+    MI_FIELD(gdb::Variable, name, "name"),
+    MI_FIELD(gdb::Variable, numChild, "numchild"),
+    MI_FIELD(gdb::Variable, value, "value"),
+    MI_FIELD_WITH(gdb::Variable, type, "type", interned),
+    MI_FIELD(gdb::Variable, threadId, "thread-id"),
+    MI_FIELD(gdb::Variable, hasMore, "has_more"),
+    MI_FIELD(gdb::Variable, dynamic, "dynamic"),
+    MI_FIELD(gdb::Variable, displayhint, "displayhint"),
+};
+
+constexpr mi::Field<gdb::Thread> THREAD_FIELDS[] = {
+    MI_FIELD(gdb::Thread, id, "id"),
+    MI_FIELD(gdb::Thread, targetId, "target-id"),
+    MI_FIELD(gdb::Thread, details, "details"),
+    MI_FIELD(gdb::Thread, name, "name"),
+    MI_FIELD_WITH(gdb::Thread, state, "state", threadState),
+    MI_FIELD_WITH(gdb::Thread, frame, "frame", threadFrame),
+    MI_FIELD(gdb::Thread, core, "core"),
+};
+
+void DebugManager::processLibraryRecord(const QString &line)
+{
+    PERF_SCOPE("DebugManager::processLibraryRecord");
+    perf::count("mi.libraryRecords");
+    // Echoing thousands of these to the log costs more than handling them,
+    // the next other record reports how many were skipped
+    self->libraryRecordsUnlogged++;
+    gdb::Library lib;
+    if (!parseLibraryRecord(line, &lib))
+        return;
+    auto it = self->libraryIndex.find(lib.id);
+    if (line.startsWith(QLatin1String("=library-loaded"))) {
+        lib.targetName = SharedCache::instance()->intern(lib.targetName);
+        if (it != self->libraryIndex.end()) {
+            self->libraries[*it] = lib;
+        } else {
+            self->libraryIndex.insert(lib.id, self->libraries.size());
+            self->libraries.append(lib);
+        }
+        emit libraryLoaded(lib.id);
+    } else if (it != self->libraryIndex.end()) {
+        // Keeps load order, unloading is rare compared to loading
+        int index = *it;
+        self->libraryIndex.erase(it);
+        self->libraries.remove(index);
+        for (int i = index; i < self->libraries.size(); i++)
+            self->libraryIndex[self->libraries.at(i).id] = i;
+        emit libraryUnloaded(lib.id);
+    } else {
+        return;
+    }
+    emit librariesChanged();
+}
+
+bool DebugManager::processHitRecord(const QString &line)
+{
+    PERF_SCOPE("DebugManager::processHitRecord");
+    // dprintf and counting breakpoints send one record per hit; when nothing
+    // but times="N" differs from the previous one, skip the MI parser
+    static const QString NUMBER{"=breakpoint-modified,bkpt={number=\""};
+    static const QString TIMES{",times=\""};
+    if (!line.startsWith(NUMBER))
+        return false;
+    int numberEnd = line.indexOf('"', NUMBER.size());
+    int timesAt = numberEnd == -1? -1 : line.indexOf(TIMES, numberEnd);
+    if (timesAt == -1)
+        return false;
+    int timesBegin = timesAt + TIMES.size();
+    int timesEnd = line.indexOf('"', timesBegin);
+    if (timesEnd == -1)
+        return false;
+    bool ok = false;
+    int bpid = line.mid(NUMBER.size(), numberEnd - NUMBER.size()).toInt(&ok);
+    int times = ok? line.mid(timesBegin, timesEnd - timesBegin).toInt(&ok) : 0;
+    if (!ok)
+        return false;
+    auto it = self->hitRecords.find(bpid);
+    auto bp = self->breakpoints.find(bpid);
+    if (it == self->hitRecords.end() || bp == self->breakpoints.end() ||
+            it->head.size() != timesBegin || it->tail.size() != line.size() - timesEnd ||
+            !line.startsWith(it->head) || !line.endsWith(it->tail)) {
+        // Something else changed, the full parse follows and updates the breakpoint
+        self->hitRecords.insert(bpid, { line.left(timesBegin), line.mid(timesEnd) });
+        return false;
+    }
+    perf::count("mi.hitRecords");
+    self->hitRecordsUnlogged++;
+    bp->times = times;
+    emit breakpointHit(bpid, times);
+    return true;
+}
+
+const QVector<gdb::Library> &DebugManager::libraries() const
+{
+    return self->libraries;
+}
+
+gdb::Frame gdb::Frame::parseMap(const QVariantMap &data)
+{
+    return mi::decode(data, FRAME_FIELDS);
 }
 
 gdb::Breakpoint gdb::Breakpoint::parseMap(const QVariantMap &data)
 {
-    gdb::Breakpoint bp;
-    bp.number = data.value("number").toInt();
-    bp.type = data.value("type").toString();
-    bp.disp = strmap({{ "keep", keep }, { "del", del }}, data.value("disp").toString(), keep);
-    bp.enable = strmap({{ "y", true }, { "n", false }}, data.value("enable").toString(), true);
-    bp.addr = data.value("addr").toString().toULongLong(nullptr, 16);
-    bp.func = data.value("func").toString();
-    bp.file = data.value("file").toString();
-    bp.fullname = data.value("fullname").toString();
-    bp.line = data.value("line").toInt();
-    bp.threadGroups = data.value("thread-groups").toStringList();
-    bp.times = data.value("times").toInt();
-    bp.originalLocation = data.value("original-location").toString();
-    return bp;
+    return mi::decode(data, BREAKPOINT_FIELDS);
 }
 
 gdb::Variable gdb::Variable::parseMap(const QVariantMap &data)
 {
-    gdb::Variable v;
-    v.name = data.value("name").toString();
-    v.numChild = data.value("numchild", 0).toInt();
-    v.value = data.value("value").toString();
-    v.type = data.value("type").toString();
-    v.threadId = data.value("thread-id").toString();
-    v.hasMore = data.value("has_more", false).toBool();
-    v.dynamic = data.value("dynamic", false).toBool();
-    v.displayhint = data.value("displayhint").toString();
-    return v;
+    return mi::decode(data, VARIABLE_FIELDS);
 }
 
 gdb::Thread gdb::Thread::parseMap(const QVariantMap &data)
 {
-    gdb::Thread t;
-    t.id = data.value("id").toInt();
-    t.targetId = data.value("target-id").toString();
-    t.details = data.value("details").toString();
-    t.name = data.value("name").toString();
-    t.state = strmap({{ "stopped", Stopped }, { "running", Running }}, data.value("state").toString(), Unknown);
-    t.frame = Frame::parseMap(data.value("frame").toMap());
-    t.core = data.value("core").toInt();
-    return t;
+    return mi::decode(data, THREAD_FIELDS);
 }
 
 gdb::AsyncContext::Reason gdb::AsyncContext::textToReason(const QString &s)
@@ -3,6 +3,7 @@
 
 #include <QHash>
 #include <QObject>
+#include <QVector>
 
 #include <functional>
 
@@ -59,6 +60,8 @@ struct Breakpoint {
     QList<QString> threadGroups;
     int times;
     QString originalLocation;
+    QString condition;
+    int ignoreCount = 0;
 
     bool isValid() const { return number != -1; }
 
@@ -77,6 +80,17 @@ struct Thread {
     static Thread parseMap(const QVariantMap& data);
 };
 
+struct Library {
+    QString id;
+    QString targetName;
+    QString hostName;
+    QString threadGroup;
+    bool symbolsLoaded = false;
+    // First address range only, enough to tell where a library sits
+    quint64 from = 0;
+    quint64 to = 0;
+};
+
 struct AsyncContext {
     enum class Reason {
         Unknown,
@@ -102,6 +116,8 @@ struct AsyncContext {
     QString threadId;
     int core;
     Frame frame;
+    // Breakpoint number of a breakpoint-hit stop
+    int bkptno = -1;
 
     static Reason textToReason(const QString& s);
     static QString reasonToText(Reason r);
@@ -117,6 +133,36 @@ public:
     enum class ResponseAction_t { Permanent, Temporal };
     using ResponseHandler_t = std::function<void (const QVariant& v)>;
 
+    // Interactive commands are written at once, the other classes wait for a
+    // free in-flight slot; queued background work is dropped on state change,
+    // its error handler then gets a payload for which isCancelled() is true
+    enum class Priority_t { Interactive, Refresh, Background };
+    // HandlerOnly results are not broadcast as updateStackFrame and friends,
+    // for queries about other threads or frames than the ones on screen
+    enum class Delivery_t { Broadcast, HandlerOnly };
+    static constexpr int PRIORITY_COUNT = 3;
+    static constexpr int MAX_IN_FLIGHT = 4;
+
+    // Pause of a breakpoint stop that gdb ended on its own, e.g. breakpoint
+    // commands ending in continue. Not a full stop cost: only hits gdb
+    // reports with *stopped are seen: conditions evaluated false (on the host
+    // or the target) and dprintf resume silently and are not part of it.
+    // Stops the user resumes through a command are not counted either
+    struct ResumePause {
+        int count = 0;
+        qint64 totalNs = 0;
+
+        double averageMs() const { return count? totalNs / 1e6 / count : 0.0; }
+    };
+
+    struct QueueStats {
+        int depth = 0;
+        quint64 sent = 0;
+        quint64 dropped = 0;
+        qint64 totalWaitMs = 0;
+        qint64 maxWaitMs = 0;
+    };
+
     Q_PROPERTY(QString gdbCommand READ gdbCommand WRITE setGdbCommand)
     Q_PROPERTY(bool remote READ isRemote)
     Q_PROPERTY(bool gdbExecuting READ isGdbExecuting)
@@ -125,12 +171,24 @@ public:
 #ifdef Q_OS_WIN
     Q_PROPERTY(QString sigintHelperCmd READ sigintHelperCmd WRITE setSigintHelperCmd)
 #endif
+    // Independent sessions (batch jobs) own their instance, the GUI uses the
+    // shared one
+    explicit DebugManager(QObject *parent = nullptr);
+    virtual ~DebugManager();
+
     static DebugManager *instance();
 
     QStringList gdbArgs() const;
     QString gdbCommand() const;
     bool isRemote() const;
     bool isGdbExecuting() const;
+    // gdb answered its first prompt, the executable is loaded
+    bool isReady() const;
+    // mi-async is on: gdb reads commands while the inferior runs
+    bool isAsync() const;
+    // non-stop is on, set by the user's init commands: the target can be read
+    // and edited while running. An all-stop session needs a stop for that
+    bool isNonStop() const;
 
     QList<gdb::Breakpoint> allBreakpoints() const;
     QList<gdb::Breakpoint> breakpointsForFile(const QString& filePath) const;
@@ -141,27 +199,66 @@ public:
 #endif
     bool isInferiorRunning() const;
 
+    void commandAndResponse(const QString& cmd,
+                            const ResponseHandler_t& handler,
+                            const ResponseHandler_t& errorHandler);
+
+    // Stop generation, bumped on every *running and *stopped record
+    int stopGeneration() const;
+
+    int enqueue(const QString& cmd, Priority_t priority,
+                const ResponseHandler_t& handler = {},
+                const ResponseHandler_t& errorHandler = {},
+                Delivery_t delivery = Delivery_t::Broadcast);
+    // True for the error payload of a request dropped before it was answered
+    static bool isCancelled(const QVariant& error);
+    QueueStats queueStats(Priority_t priority) const;
+    int commandsInFlight() const;
+
+    ResumePause resumePause(int bpid) const;
+
+    // Shared libraries currently loaded, in load order
+    const QVector<gdb::Library>& libraries() const;
+
 public slots:
     void execute();
     void quit();
 
     void command(const QString& cmd);
+    // A command typed by the user, treated as resuming the inferior
+    void userCommand(const QString& cmd);
     void commandAndResponse(const QString& cmd,
                             const ResponseHandler_t& handler,
                             ResponseAction_t action = ResponseAction_t::Temporal);
+    int contextCommand(const QString& cmd, const ResponseHandler_t& handler = {});
+    void cancel(int token);
 
+    // In all-stop, edits made while the inferior runs interrupt it, apply the
+    // edit and resume it, without the stop reaching asyncStopped
     void breakRemove(int bpid);
     void breakInsert(const QString& path);
+    // An empty condition makes the breakpoint unconditional again
+    void breakCondition(int bpid, const QString& condition);
+    void breakAfter(int bpid, int count);
+    // "auto", "host" or "target", applies to every breakpoint
+    void setConditionEvaluation(const QString& mode);
+    // Whether the remote stub evaluates conditions itself (ConditionalBreakpoints
+    // in its qSupported reply), always false for a native session
+    void queryTargetConditions(const std::function<void(bool)>& handler);
 
     void loadExecutable(const QString& file);
     void launchRemote(const QString& remoteTarget);
     void launchLocal();
 
+    // All threads, in non-stop mode as well
     void commandContinue();
     void commandNext();
     void commandStep();
     void commandFinish();
-    void commandInterrupt();
+    // All threads, or only thread when given (non-stop mode)
+    void commandInterrupt(int thread = -1);
+    void commandNextInstruction();
+    void commandStepInstruction();
 
     void traceAddVariable(const QString& expr, const QString& name="-", int frame=-1);
     void traceDelVariable(const QString& name);
@@ -198,11 +295,19 @@ signals:
     void breakpointInserted(const gdb::Breakpoint& bp);
     void breakpointModified(const gdb::Breakpoint& bp);
     void breakpointRemoved(const gdb::Breakpoint& bp);
+    void resumePauseChanged(int bpid);
+    // Only the hit count changed, sent instead of breakpointModified
+    void breakpointHit(int bpid, int times);
 
     void variableCreated(const gdb::Variable& v);
     void variableDeleted(const gdb::Variable& v);
     void variablesChanged(const QStringList& changedNames);
 
+    void memoryChanged(quint64 addr, quint64 len);
+    void libraryLoaded(const QString& id);
+    void libraryUnloaded(const QString& id);
+    void librariesChanged();
+
     void result(int token, const QString& reason, const QVariant& results); // <token>^...
     void streamConsole(const QString& text);
     void streamTarget(const QString& text);
@@ -213,8 +318,13 @@ private slots:
     void processLine(const QString& line);
 
 private:
-    explicit DebugManager(QObject *parent = nullptr);
-    virtual ~DebugManager();
+    void dispatchQueued();
+    void newStopGeneration();
+    void processLibraryRecord(const QString& line);
+    bool processHitRecord(const QString& line);
+    void breakRefresh(int bpid);
+    void resumeCommand(const QString& cmd);
+    void whileStopped(const std::function<void()>& edit);
 
     struct Priv_t;
     Priv_t *self;
@@ -0,0 +1,45 @@
+#include "dialogbreakpoint.h"
+#include "ui_dialogbreakpoint.h"
+
+DialogBreakpoint::DialogBreakpoint(const gdb::Breakpoint &bp, const DebugManager::ResumePause &pause,
+                                   bool remote, bool targetConditions, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DialogBreakpoint)
+{
+    ui->setupUi(this);
+    setWindowTitle(tr("Breakpoint %1").arg(bp.number));
+    ui->labelLocation->setText(bp.file.isEmpty()? bp.originalLocation : QString{"%1:%2"}.arg(bp.file).arg(bp.line));
+    ui->editorCondition->setText(bp.condition);
+    ui->spinIgnore->setValue(bp.ignoreCount);
+    ui->labelHits->setText(QString::number(bp.times));
+    ui->labelPause->setText(pause.count?
+                                tr("%1 ms average over %2 automatic resumes")
+                                .arg(pause.averageMs(), 0, 'f', 2).arg(pause.count) :
+                               tr("not measured yet"));
+    // Items are auto, host, target: prefer the stub when it can do it
+    ui->comboEvaluation->setCurrentIndex(targetConditions? 2 : 1);
+    ui->comboEvaluation->setEnabled(remote);
+}
+
+DialogBreakpoint::~DialogBreakpoint()
+{
+    delete ui;
+}
+
+QString DialogBreakpoint::condition() const
+{
+    return ui->editorCondition->text().trimmed();
+}
+
+int DialogBreakpoint::ignoreCount() const
+{
+    return ui->spinIgnore->value();
+}
+
+QString DialogBreakpoint::conditionEvaluation() const
+{
+    if (!ui->comboEvaluation->isEnabled())
+        return {};
+    static const char *modes[] = { "auto", "host", "target" };
+    return modes[ui->comboEvaluation->currentIndex()];
+}
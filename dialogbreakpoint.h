@@ -0,0 +1,33 @@
+#ifndef DIALOGBREAKPOINT_H
+#define DIALOGBREAKPOINT_H
+
+#include <QDialog>
+
+#include "debugmanager.h"
+
+namespace Ui {
+class DialogBreakpoint;
+}
+
+class DialogBreakpoint : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // Target side evaluation needs a remote stub running agent expressions,
+    // for a native session the choice is disabled. It is preselected only when
+    // the stub reported support for it
+    explicit DialogBreakpoint(const gdb::Breakpoint& bp, const DebugManager::ResumePause& pause,
+                              bool remote, bool targetConditions, QWidget *parent = nullptr);
+    ~DialogBreakpoint();
+
+    QString condition() const;
+    int ignoreCount() const;
+    // Value for DebugManager::setConditionEvaluation, empty to leave it as is
+    QString conditionEvaluation() const;
+
+private:
+    Ui::DialogBreakpoint *ui;
+};
+
+#endif // DIALOGBREAKPOINT_H
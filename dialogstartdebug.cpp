@@ -1,36 +1,13 @@
 #include "dialogstartdebug.h"
 #include "ui_dialogstartdebug.h"
+#include "gdblocator.h"
+#include "perfstats.h"
 
 #include <QFileDialog>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTextStream>
-#include <QProcessEnvironment>
-
-#ifdef Q_OS_WIN
-static constexpr QLatin1Char PATH_SEPARATOR{';'};
-#else
-static constexpr QLatin1Char PATH_SEPARATOR{':'};
-#endif
-
-static const QRegularExpression GDB_PATTERN_IN_PATH{R"(^([\w_\-]+\-)?gdb(\.exe)?$)"};
-
-static QStringList findPatternInPath(const QRegularExpression& re) {
-    QSet<QString> fileList;
-    auto paths = QProcessEnvironment::systemEnvironment().value("PATH").split(PATH_SEPARATOR);
-    for (const auto& e: paths)
-        for (const auto& f: QDir{e}.entryInfoList())
-            if (re.match(f.fileName()).hasMatch())
-                fileList += f.absoluteFilePath();
-    return fileList.toList();
-}
-
-static bool processObject(QComboBox *b, const QJsonObject& j)
-{
-    b->addItem(j.value("name").toString(), j.toVariantMap());
-    return j.value("default").toBool(false);
-}
 
 static QFileInfoList glob(const QString& path, const QString& g)
 {
@@ -42,53 +19,65 @@ static QFileInfoList appGlob(const QString& path, const QString& g)
     return glob(QApplication::applicationDirPath() + path, g);
 }
 
-DialogStartDebug::DialogStartDebug(QWidget *parent) :
-    QDialog(parent),
-    ui(new Ui::DialogStartDebug)
+// Parsed on the first dialog and kept for the rest of the process
+static const QList<QVariantMap>& initTemplates()
 {
-    m_needWriteInitScript = true;
-    ui->setupUi(this);
-
+    static QList<QVariantMap> templates;
+    static bool loaded = false;
+    if (loaded)
+        return templates;
+    PERF_SCOPE("DialogStartDebug::loadTemplates");
+    loaded = true;
     auto templateList = glob(":/gdbinit", "*.json") +
                         appGlob("/../share/gdbfront/", "gdbinit*.json") +
                         appGlob("/gdbfront/", "gdbinit*.json");
-    int defaultIdx = 0;
     for (const auto& e: templateList) {
         QFile f{e.absoluteFilePath()};
         if (f.open(QFile::ReadOnly)) {
             auto doc = QJsonDocument::fromJson(f.readAll());
             if (doc.isObject()) {
-                if (processObject(ui->comboGdbInitTemplates, doc.object()))
-                    defaultIdx = ui->comboGdbInitTemplates->count() - 1;
+                templates.append(doc.object().toVariantMap());
             } else if (doc.isArray()) {
-                for (const QJsonValueRef g: doc.array()) {
-                    if (processObject(ui->comboGdbInitTemplates, g.toObject()))
-                        defaultIdx = ui->comboGdbInitTemplates->count() - 1;
-                }
+                for (const QJsonValueRef g: doc.array())
+                    templates.append(g.toObject().toVariantMap());
             }
         }
     }
-    auto detectGdbFor = [this](int idx) {
+    return templates;
+}
+
+DialogStartDebug::DialogStartDebug(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DialogStartDebug)
+{
+    PERF_SCOPE("DialogStartDebug::DialogStartDebug");
+    m_needWriteInitScript = true;
+    ui->setupUi(this);
+
+    int defaultIdx = 0;
+    for (const auto& j: initTemplates()) {
+        ui->comboGdbInitTemplates->addItem(j.value("name").toString(), j);
+        if (j.value("default").toBool())
+            defaultIdx = ui->comboGdbInitTemplates->count() - 1;
+    }
+    connect(ui->comboGdbInitTemplates, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int idx) {
         auto j = ui->comboGdbInitTemplates->itemData(idx).toMap();
-        auto pattern = j.value("preferredGdb").toString();
-        auto preferredGdb = QRegularExpression{pattern, QRegularExpression::MultilineOption};
         ui->editorInitScript->setPlainText(j.value("commands").toStringList().join('\n'));
-        ui->editorGdbExecFile->setCurrentIndex(-1);
-        for (int i=0; i<ui->editorGdbExecFile->count(); i++) {
-            QFileInfo info{ui->editorGdbExecFile->itemText(i)};
-            auto name = info.baseName();
-            if (preferredGdb.match(name).hasMatch()) {
-                ui->editorGdbExecFile->setCurrentIndex(i);
-                break;
-            }
-        }
-    };
-    connect(ui->comboGdbInitTemplates, QOverload<int>::of(&QComboBox::currentIndexChanged), detectGdbFor);
+        selectPreferredGdb();
+    });
     ui->comboGdbInitTemplates->setCurrentIndex(defaultIdx);
 
+    // The PATH scan normally finished long before the dialog is opened
+    auto locator = GdbLocator::instance();
     ui->editorGdbExecFile->clear();
-    ui->editorGdbExecFile->addItems(findPatternInPath(GDB_PATTERN_IN_PATH));
-    detectGdbFor(defaultIdx);
+    if (locator->isReady()) {
+        setGdbCandidates(locator->candidates());
+    } else {
+        connect(locator, &GdbLocator::ready, this, &DialogStartDebug::setGdbCandidates);
+        locator->start();
+    }
+    auto j = ui->comboGdbInitTemplates->itemData(defaultIdx).toMap();
+    ui->editorInitScript->setPlainText(j.value("commands").toStringList().join('\n'));
 
     connect(ui->buttonChoseExecutable, &QToolButton::clicked, [this]() {
         auto name = QFileDialog::getOpenFileName(this, tr("Select file"));
@@ -152,6 +141,44 @@ QString DialogStartDebug::gdbExecutable() const
     return ui->editorGdbExecFile->currentText();
 }
 
+bool DialogStartDebug::prewarm() const
+{
+    return ui->checkPrewarm->isChecked();
+}
+
+void DialogStartDebug::setGdbCandidates(const QStringList &candidates)
+{
+    auto chosen = ui->editorGdbExecFile->currentText();
+    ui->editorGdbExecFile->clear();
+    ui->editorGdbExecFile->addItems(candidates);
+    if (chosen.isEmpty()) {
+        selectPreferredGdb();
+    } else {
+        int idx = ui->editorGdbExecFile->findText(chosen);
+        if (idx == -1) {
+            ui->editorGdbExecFile->insertItem(0, chosen);
+            idx = 0;
+        }
+        ui->editorGdbExecFile->setCurrentIndex(idx);
+    }
+}
+
+void DialogStartDebug::selectPreferredGdb()
+{
+    auto j = ui->comboGdbInitTemplates->currentData().toMap();
+    auto pattern = j.value("preferredGdb").toString();
+    auto preferredGdb = QRegularExpression{pattern, QRegularExpression::MultilineOption};
+    ui->editorGdbExecFile->setCurrentIndex(-1);
+    for (int i=0; i<ui->editorGdbExecFile->count(); i++) {
+        QFileInfo info{ui->editorGdbExecFile->itemText(i)};
+        auto name = info.baseName();
+        if (preferredGdb.match(name).hasMatch()) {
+            ui->editorGdbExecFile->setCurrentIndex(i);
+            break;
+        }
+    }
+}
+
 void DialogStartDebug::loadInitScript(const QString &path)
 {
     QFileInfo initScript{path};
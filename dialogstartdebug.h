@@ -17,6 +17,7 @@ public:
     Q_PROPERTY(QString initScript READ initScript)
     Q_PROPERTY(bool needWriteInitScript READ needWriteInitScript)
     Q_PROPERTY(QString gdbExecutable READ gdbExecutable)
+    Q_PROPERTY(bool prewarm READ prewarm)
 
     explicit DialogStartDebug(QWidget *parent = nullptr);
     ~DialogStartDebug();
@@ -32,11 +33,17 @@ public:
     }
 
     QString gdbExecutable() const;
+    bool prewarm() const;
 
 public slots:
     void loadInitScript(const QString& path = {});
 
+private slots:
+    void setGdbCandidates(const QStringList& candidates);
+
 private:
+    void selectPreferredGdb();
+
     Ui::DialogStartDebug *ui;
     bool m_needWriteInitScript;
     QString m_gdbExecutable;
@@ -0,0 +1,268 @@
+#include "disassemblyview.h"
+
+#include <Qsci/qsciscintilla.h>
+
+#include <QCheckBox>
+#include <QFile>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QTextStream>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+constexpr quint64 DisassemblyView::WINDOW_SIZE;
+
+static DisassemblyView::Line parseInstruction(const QVariantMap& m, QString *func)
+{
+    DisassemblyView::Line l;
+    if (func->isEmpty())
+        *func = m.value("func-name").toString();
+    l.addr = m.value("address").toString().toULongLong(nullptr, 16);
+    l.offset = m.value("offset").toInt();
+    l.text = m.value("inst").toString();
+    return l;
+}
+
+DisassemblyView::DisassemblyView(QWidget *parent) :
+    QWidget(parent),
+    m_editor(new QsciScintilla(this)),
+    m_mixed(new QCheckBox(tr("Source"), this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    auto buttonStepInstruction = new QToolButton(this);
+    auto buttonNextInstruction = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    buttonStepInstruction->setIcon(QIcon{":/images/debug-step-into-v2.svg"});
+    buttonStepInstruction->setToolTip(tr("Step one instruction"));
+    buttonNextInstruction->setIcon(QIcon{":/images/debug-step-over-v2.svg"});
+    buttonNextInstruction->setToolTip(tr("Next instruction"));
+    m_mixed->setChecked(true);
+    toolbar->addWidget(buttonStepInstruction);
+    toolbar->addWidget(buttonNextInstruction);
+    toolbar->addWidget(m_mixed);
+    toolbar->addStretch();
+    layout->addLayout(toolbar);
+    layout->addWidget(m_editor);
+
+    m_editor->setReadOnly(true);
+    m_editor->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_editor->setMarginWidth(0, 0);
+    m_editor->setMarginType(1, QsciScintilla::SymbolMargin);
+    m_editor->setMarginWidth(1, "00");
+    m_editor->setMarginSensitivity(1, true);
+    m_editor->markerDefine(QsciScintilla::Background, QsciScintilla::SC_MARK_BACKGROUND);
+    m_editor->setMarkerBackgroundColor(QColor("#eeee11"), QsciScintilla::SC_MARK_BACKGROUND);
+
+    connect(buttonStepInstruction, &QToolButton::clicked, [this]() {
+        if (m_debug)
+            m_debug->commandStepInstruction();
+    });
+    connect(buttonNextInstruction, &QToolButton::clicked, [this]() {
+        if (m_debug)
+            m_debug->commandNextInstruction();
+    });
+    connect(m_mixed, &QCheckBox::toggled, this, &DisassemblyView::refresh);
+    connect(m_editor, &QsciScintilla::marginClicked, this, &DisassemblyView::marginClicked);
+}
+
+void DisassemblyView::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    clear();
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncStopped, this, [this](const gdb::AsyncContext& ctx) {
+        showAddress(ctx.frame.addr);
+    });
+    connect(g, &DebugManager::updateCurrentFrame, this, [this](const gdb::Frame& frame) {
+        showAddress(frame.addr);
+    });
+    connect(g, &DebugManager::libraryLoaded, this, &DisassemblyView::invalidate);
+    connect(g, &DebugManager::libraryUnloaded, this, &DisassemblyView::invalidate);
+    connect(g, &DebugManager::started, this, &DisassemblyView::clear);
+    connect(g, &DebugManager::terminated, this, &DisassemblyView::clear);
+}
+
+void DisassemblyView::showAddress(quint64 pc)
+{
+    m_pc = pc;
+    if (isVisible())
+        refresh();
+}
+
+void DisassemblyView::invalidate()
+{
+    m_ranges.clear();
+    m_sources.clear();
+    m_requested.clear();
+    m_loading.clear();
+}
+
+void DisassemblyView::clear()
+{
+    invalidate();
+    m_pc = 0;
+    m_lineAddr.clear();
+    m_editor->clear();
+}
+
+void DisassemblyView::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+    refresh();
+}
+
+void DisassemblyView::refresh()
+{
+    if (m_pc == 0)
+        return;
+    auto r = rangeFor(m_pc);
+    if (r) {
+        render(*r);
+        return;
+    }
+    if (!m_requested.contains(m_pc))
+        fetch(m_pc);
+    if (m_loading.contains(m_pc))
+        m_editor->setText(tr("Disassembling 0x%1...").arg(m_pc, 0, 16));
+    else if (m_requested.contains(m_pc))
+        m_editor->setText(tr("No code at 0x%1").arg(m_pc, 0, 16));
+}
+
+void DisassemblyView::marginClicked(int margin, int line, Qt::KeyboardModifiers)
+{
+    if (margin != 1 || !m_debug || line < 0 || line >= m_lineAddr.size())
+        return;
+    auto addr = m_lineAddr.at(line);
+    if (addr)
+        m_debug->breakInsert(QString{"*0x%1"}.arg(addr, 0, 16));
+}
+
+const DisassemblyView::Range *DisassemblyView::rangeFor(quint64 addr) const
+{
+    auto it = m_ranges.upperBound(addr);
+    if (it == m_ranges.cbegin())
+        return nullptr;
+    --it;
+    return (addr >= it->start && addr < it->end)? &it.value() : nullptr;
+}
+
+void DisassemblyView::fetch(quint64 pc)
+{
+    if (!m_debug || (m_debug->isInferiorRunning() && !m_debug->isNonStop()))
+        return;
+    m_requested.insert(pc);
+    m_loading.insert(pc);
+    auto done = [this, pc](const QVariant& r) {
+        if (!m_loading.remove(pc))
+            return;
+        // Dropped by a state change, not an answer: ask again next time
+        if (DebugManager::isCancelled(r))
+            m_requested.remove(pc);
+        else
+            storeRange(r.toMap().value("asm_insns").toList());
+        refresh();
+    };
+    // Whole function around pc first, mode 4 is mixed source and disassembly
+    auto cmd = QString{"-data-disassemble -a 0x%1 -- 4"}.arg(pc, 0, 16);
+    m_debug->enqueue(cmd, DebugManager::Priority_t::Refresh, done, [this, pc, done](const QVariant& r) {
+        if (!m_loading.contains(pc) || DebugManager::isCancelled(r)) {
+            done(r);
+            return;
+        }
+        // No function covers pc (stripped code, trampolines...): use a window
+        auto cmd = QString{"-data-disassemble -s 0x%1 -e 0x%2 -- 4"}
+                .arg(pc, 0, 16)
+                .arg(pc + WINDOW_SIZE, 0, 16);
+        m_debug->enqueue(cmd, DebugManager::Priority_t::Refresh, done, done);
+    });
+}
+
+void DisassemblyView::storeRange(const QVariantList &insns)
+{
+    Range range;
+    if (!insns.isEmpty() && insns.first().toMap().contains("src_and_asm_line")) {
+        auto sourceLines = insns.first().toMap().values("src_and_asm_line");
+        std::reverse(sourceLines.begin(), sourceLines.end());
+        for (const auto& e: sourceLines) {
+            auto m = e.toMap();
+            Line src;
+            src.sourceLine = m.value("line").toInt();
+            src.fullname = m.value("fullname").toString();
+            range.lines.append(src);
+            for (const auto& i: m.value("line_asm_insn").toList())
+                range.lines.append(parseInstruction(i.toMap(), &range.func));
+        }
+    } else {
+        for (const auto& i: insns)
+            range.lines.append(parseInstruction(i.toMap(), &range.func));
+    }
+    range.start = ~quint64(0);
+    for (const auto& l: range.lines) {
+        if (l.isSource())
+            continue;
+        range.start = qMin(range.start, l.addr);
+        range.end = qMax(range.end, l.addr + 1);
+    }
+    if (range.end == 0)
+        return;
+    m_ranges.insert(range.start, range);
+}
+
+void DisassemblyView::render(const Range &r)
+{
+    QList<Line> lines;
+    if (m_mixed->isChecked()) {
+        lines = r.lines;
+    } else {
+        for (const auto& l: r.lines)
+            if (!l.isSource())
+                lines.append(l);
+        std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+            return a.addr < b.addr;
+        });
+    }
+    QStringList text;
+    int currentLine = -1;
+    m_lineAddr.clear();
+    for (const auto& l: lines) {
+        if (l.isSource()) {
+            text.append(QString{"%1\t%2"}.arg(l.sourceLine).arg(sourceText(l.fullname, l.sourceLine)));
+            m_lineAddr.append(0);
+        } else {
+            if (l.addr == m_pc)
+                currentLine = text.size();
+            text.append(QString{"  0x%1 <+%2>\t%3"}.arg(l.addr, 16, 16, QChar{'0'}).arg(l.offset).arg(l.text));
+            m_lineAddr.append(l.addr);
+        }
+    }
+    m_editor->setText(text.join('\n'));
+    m_editor->markerDeleteAll(QsciScintilla::SC_MARK_BACKGROUND);
+    if (currentLine != -1) {
+        m_editor->markerAdd(currentLine, QsciScintilla::SC_MARK_BACKGROUND);
+        m_editor->ensureLineVisible(currentLine);
+    }
+}
+
+QString DisassemblyView::sourceText(const QString &fullname, int line)
+{
+    auto it = m_sources.find(fullname);
+    if (it == m_sources.end()) {
+        QStringList lines;
+        QFile f{fullname};
+        if (f.open(QFile::ReadOnly)) {
+            QTextStream ss(&f);
+            while (!ss.atEnd())
+                lines.append(ss.readLine());
+        }
+        it = m_sources.insert(fullname, lines);
+    }
+    return it.value().value(line - 1);
+}
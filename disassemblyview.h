@@ -0,0 +1,73 @@
+#ifndef DISASSEMBLYVIEW_H
+#define DISASSEMBLYVIEW_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QWidget>
+
+#include "debugmanager.h"
+
+class QCheckBox;
+class QsciScintilla;
+
+class DisassemblyView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Line {
+        quint64 addr = 0;
+        int offset = 0;
+        QString text;
+        int sourceLine = 0;
+        QString fullname;
+
+        bool isSource() const { return sourceLine > 0; }
+    };
+
+    struct Range {
+        quint64 start = 0;
+        quint64 end = 0;
+        QString func;
+        QList<Line> lines;
+    };
+
+    static constexpr quint64 WINDOW_SIZE = 256;
+
+    explicit DisassemblyView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    void showAddress(quint64 pc);
+    void invalidate();
+    void clear();
+
+protected:
+    virtual void showEvent(QShowEvent *e);
+
+private slots:
+    void refresh();
+    void marginClicked(int margin, int line, Qt::KeyboardModifiers);
+
+private:
+    const Range *rangeFor(quint64 addr) const;
+    void fetch(quint64 pc);
+    void storeRange(const QVariantList& insns);
+    void render(const Range& r);
+    QString sourceText(const QString& fullname, int line);
+
+    DebugManager *m_debug = nullptr;
+    QsciScintilla *m_editor;
+    QCheckBox *m_mixed;
+    QMap<quint64, Range> m_ranges;
+    QHash<QString, QStringList> m_sources;
+    QSet<quint64> m_requested;
+    // Requested pcs whose reply, or final error, has not arrived yet
+    QSet<quint64> m_loading;
+    QList<quint64> m_lineAddr;
+    quint64 m_pc = 0;
+};
+
+#endif // DISASSEMBLYVIEW_H
@@ -0,0 +1,128 @@
+#include "elfinfo.h"
+
+#include <QFile>
+
+namespace conf {
+namespace elf {
+
+constexpr int EI_NIDENT = 16;
+constexpr int ELFCLASS64 = 2;
+constexpr int ELFDATA2LSB = 1;
+constexpr quint32 SHT_NOTE = 7;
+constexpr quint32 PT_NOTE = 4;
+constexpr quint32 NT_GNU_BUILD_ID = 3;
+// Build-id notes are tens of bytes, anything bigger is not worth reading
+constexpr quint64 MAX_NOTE_SIZE = 1 << 16;
+constexpr int MAX_TABLE_ENTRIES = 1 << 12;
+
+}
+}
+
+class Reader
+{
+public:
+    Reader(QFile& f, bool is64, bool le) : m_file(f), m_is64(is64), m_le(le) {}
+
+    bool is64() const { return m_is64; }
+
+    QByteArray read(quint64 offset, quint64 size)
+    {
+        if (!m_file.seek(qint64(offset)))
+            return {};
+        auto data = m_file.read(qint64(size));
+        return quint64(data.size()) == size? data : QByteArray{};
+    }
+
+    quint64 word(const QByteArray& data, int offset, int size) const
+    {
+        if (offset < 0 || offset + size > data.size())
+            return 0;
+        quint64 v = 0;
+        for (int i = 0; i < size; i++) {
+            int k = m_le? offset + size - 1 - i : offset + i;
+            v = (v << 8) | uchar(data.at(k));
+        }
+        return v;
+    }
+
+    // Offset/address sized field, 4 or 8 bytes depending on the class
+    quint64 addr(const QByteArray& data, int offset32, int offset64) const
+    {
+        return m_is64? word(data, offset64, 8) : word(data, offset32, 4);
+    }
+
+private:
+    QFile& m_file;
+    bool m_is64;
+    bool m_le;
+};
+
+static QByteArray findBuildId(Reader& r, quint64 offset, quint64 size)
+{
+    if (size == 0 || size > conf::elf::MAX_NOTE_SIZE)
+        return {};
+    auto notes = r.read(offset, size);
+    int pos = 0;
+    while (pos + 12 <= notes.size()) {
+        auto nameSize = r.word(notes, pos, 4);
+        auto descSize = r.word(notes, pos + 4, 4);
+        auto type = r.word(notes, pos + 8, 4);
+        if (nameSize > quint64(notes.size()) || descSize > quint64(notes.size()))
+            break;
+        int name = pos + 12;
+        int desc = name + ((int(nameSize) + 3) & ~3);
+        if (desc + int(descSize) > notes.size())
+            break;
+        if (type == conf::elf::NT_GNU_BUILD_ID && notes.mid(name, int(nameSize)) == QByteArray("GNU", 4))
+            return notes.mid(desc, int(descSize));
+        pos = desc + ((int(descSize) + 3) & ~3);
+    }
+    return {};
+}
+
+QByteArray elf::buildId(const QString &path)
+{
+    QFile f{path};
+    if (!f.open(QFile::ReadOnly))
+        return {};
+    auto ident = f.read(conf::elf::EI_NIDENT);
+    if (ident.size() != conf::elf::EI_NIDENT || !ident.startsWith("\x7f" "ELF"))
+        return {};
+    Reader r{f, ident.at(4) == conf::elf::ELFCLASS64, ident.at(5) == conf::elf::ELFDATA2LSB};
+    auto header = r.read(0, r.is64()? 64 : 52);
+    if (header.isEmpty())
+        return {};
+
+    // Section headers first, linker scripts of bare metal targets often keep
+    // the note outside of any loadable segment
+    auto shoff = r.addr(header, 0x20, 0x28);
+    auto shentsize = int(r.word(header, r.is64()? 0x3A : 0x2E, 2));
+    auto shnum = int(r.word(header, r.is64()? 0x3C : 0x30, 2));
+    if (shoff && shnum > 0 && shnum < conf::elf::MAX_TABLE_ENTRIES && shentsize > 0) {
+        auto table = r.read(shoff, quint64(shentsize) * quint64(shnum));
+        for (int i = 0; i < shnum && !table.isEmpty(); i++) {
+            auto entry = table.mid(i * shentsize, shentsize);
+            if (r.word(entry, 4, 4) != conf::elf::SHT_NOTE)
+                continue;
+            auto id = findBuildId(r, r.addr(entry, 0x10, 0x18), r.addr(entry, 0x14, 0x20));
+            if (!id.isEmpty())
+                return id;
+        }
+    }
+
+    auto phoff = r.addr(header, 0x1C, 0x20);
+    auto phentsize = int(r.word(header, r.is64()? 0x36 : 0x2A, 2));
+    auto phnum = int(r.word(header, r.is64()? 0x38 : 0x2C, 2));
+    if (phoff && phnum > 0 && phnum < conf::elf::MAX_TABLE_ENTRIES && phentsize > 0) {
+        auto table = r.read(phoff, quint64(phentsize) * quint64(phnum));
+        for (int i = 0; i < phnum && !table.isEmpty(); i++) {
+            auto entry = table.mid(i * phentsize, phentsize);
+            if (r.word(entry, 0, 4) != conf::elf::PT_NOTE)
+                continue;
+            auto id = findBuildId(r, r.addr(entry, 0x04, 0x08), r.addr(entry, 0x10, 0x20));
+            if (!id.isEmpty())
+                return id;
+        }
+    }
+    return {};
+}
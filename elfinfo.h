@@ -0,0 +1,14 @@
+#ifndef ELFINFO_H
+#define ELFINFO_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace elf {
+
+// GNU build-id note of an ELF file, empty if the file has none or is not ELF
+QByteArray buildId(const QString& path);
+
+}
+
+#endif // ELFINFO_H
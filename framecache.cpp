@@ -0,0 +1,36 @@
+#include "framecache.h"
+
+const FrameCache::Entry *FrameCache::find(int generation, int thread, int level)
+{
+    sync(generation);
+    auto it = m_entries.constFind(key(thread, level));
+    return it == m_entries.cend()? nullptr : &it.value();
+}
+
+void FrameCache::setFrame(int generation, int thread, const gdb::Frame &frame)
+{
+    sync(generation);
+    m_entries[key(thread, frame.level)].frame = frame;
+}
+
+void FrameCache::setLocals(int generation, int thread, int level, const QList<gdb::Variable> &locals)
+{
+    sync(generation);
+    auto& e = m_entries[key(thread, level)];
+    e.locals = locals;
+    e.hasLocals = true;
+}
+
+void FrameCache::clear()
+{
+    m_entries.clear();
+    m_generation = -1;
+}
+
+void FrameCache::sync(int generation)
+{
+    if (generation != m_generation) {
+        m_entries.clear();
+        m_generation = generation;
+    }
+}
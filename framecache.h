@@ -0,0 +1,33 @@
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <QHash>
+
+#include "debugmanager.h"
+
+// Context of the frames visited during one stop, keyed by (stop generation,
+// thread, level). Going back to a frame in the stack view then needs no
+// gdb round trip; entries of older stops are dropped on the first access.
+class FrameCache
+{
+public:
+    struct Entry {
+        gdb::Frame frame;
+        QList<gdb::Variable> locals;
+        bool hasLocals;
+    };
+
+    const Entry *find(int generation, int thread, int level);
+    void setFrame(int generation, int thread, const gdb::Frame& frame);
+    void setLocals(int generation, int thread, int level, const QList<gdb::Variable>& locals);
+    void clear();
+
+private:
+    void sync(int generation);
+    static quint64 key(int thread, int level) { return (quint64(quint32(thread)) << 32) | quint32(level); }
+
+    int m_generation = -1;
+    QHash<quint64, Entry> m_entries;
+};
+
+#endif // FRAMECACHE_H
@@ -1,5 +1,5 @@
 DESTDIR  = build
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -18,22 +18,81 @@ DEFINES += QT_DEPRECATED_WARNINGS
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    batchrunner.cpp \
+    breakpointview.cpp \
+    contextrefresher.cpp \
     debugmanager.cpp \
     dialogabout.cpp \
+    dialogbreakpoint.cpp \
     dialognewwatch.cpp \
     dialogstartdebug.cpp \
+    disassemblyview.cpp \
+    elfinfo.cpp \
+    framecache.cpp \
+    gdblocator.cpp \
+    gdbpool.cpp \
+    hoverevaluator.cpp \
+    inlinevalues.cpp \
+    libraryview.cpp \
+    livesampler.cpp \
     main.cpp \
-    mainwidget.cpp
+    mainwidget.cpp \
+    memorycache.cpp \
+    memoryview.cpp \
+    midecoder.cpp \
+    parallelstacksview.cpp \
+    perfstats.cpp \
+    perfview.cpp \
+    profiler.cpp \
+    profilerview.cpp \
+    registerview.cpp \
+    samplerview.cpp \
+    schedulerview.cpp \
+    sharedcache.cpp \
+    sourceloader.cpp \
+    stackcollector.cpp \
+    symbolindex.cpp \
+    symbolview.cpp
 
 HEADERS += \
+    batchrunner.h \
+    breakpointview.h \
+    contextrefresher.h \
     debugmanager.h \
     dialogabout.h \
+    dialogbreakpoint.h \
     dialognewwatch.h \
     dialogstartdebug.h \
-    mainwidget.h
+    disassemblyview.h \
+    elfinfo.h \
+    framecache.h \
+    gdblocator.h \
+    gdbpool.h \
+    hoverevaluator.h \
+    inlinevalues.h \
+    libraryview.h \
+    livesampler.h \
+    mainwidget.h \
+    memorycache.h \
+    memoryview.h \
+    midecoder.h \
+    parallelstacksview.h \
+    perfstats.h \
+    perfview.h \
+    profiler.h \
+    profilerview.h \
+    registerview.h \
+    samplerview.h \
+    schedulerview.h \
+    sharedcache.h \
+    sourceloader.h \
+    stackcollector.h \
+    symbolindex.h \
+    symbolview.h
 
 FORMS += \
     dialogabout.ui \
+    dialogbreakpoint.ui \
     dialognewwatch.ui \
     dialogstartdebug.ui \
     mainwidget.ui
@@ -0,0 +1,123 @@
+#include "gdblocator.h"
+#include "perfstats.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcessEnvironment>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#ifdef Q_OS_WIN
+static constexpr QLatin1Char PATH_SEPARATOR{';'};
+#else
+static constexpr QLatin1Char PATH_SEPARATOR{':'};
+#endif
+
+namespace conf {
+namespace locator {
+
+constexpr int CACHE_VERSION = 1;
+const auto CACHE_FILE = QLatin1String("gdb-path.json");
+
+}
+}
+
+const QRegularExpression GdbLocator::GDB_PATTERN{R"(^([\w_\-]+\-)?gdb(\.exe)?$)"};
+
+GdbLocator *GdbLocator::instance()
+{
+    static GdbLocator *self = nullptr;
+    if (!self)
+        self = new GdbLocator;
+    return self;
+}
+
+GdbLocator::GdbLocator(QObject *parent) :
+    QObject(parent),
+    m_watcher(new QFutureWatcher<Result>(this))
+{
+    connect(m_watcher, &QFutureWatcher<Result>::finished, this, [this]() {
+        auto r = m_watcher->result();
+        m_candidates = r.candidates;
+        m_ready = true;
+        // The worker thread must not touch the statistics, report from here
+        if (perf::enabled) {
+            auto s = perf::Stats::instance();
+            s->addTime("GdbLocator::scan", m_startNs, r.elapsedNs);
+            s->addCount("GdbLocator.dirsListed", r.dirsListed);
+        }
+        emit ready(m_candidates);
+    });
+}
+
+void GdbLocator::start()
+{
+    if (m_ready || m_watcher->isRunning())
+        return;
+    auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir{}.mkpath(cacheDir);
+    auto path = QProcessEnvironment::systemEnvironment().value("PATH");
+    m_startNs = perf::Stats::instance()->now();
+    m_watcher->setFuture(QtConcurrent::run(&GdbLocator::locate, path,
+                                           QDir{cacheDir}.filePath(conf::locator::CACHE_FILE)));
+}
+
+GdbLocator::Result GdbLocator::locate(const QString &path, const QString &cacheFile)
+{
+    QElapsedTimer clock;
+    clock.start();
+    QJsonObject cached;
+    QFile f{cacheFile};
+    if (f.open(QFile::ReadOnly)) {
+        auto doc = QJsonDocument::fromJson(f.readAll()).object();
+        if (doc.value("version").toInt() == conf::locator::CACHE_VERSION)
+            cached = doc.value("dirs").toObject();
+        f.close();
+    }
+
+    Result r;
+    QJsonObject dirs;
+    QSet<QString> seen;
+    for (const auto& e: path.split(PATH_SEPARATOR)) {
+        QFileInfo info{e};
+        auto dir = info.absoluteFilePath();
+        if (seen.contains(dir) || !info.isDir())
+            continue;
+        seen.insert(dir);
+        auto mtime = info.lastModified().toMSecsSinceEpoch();
+        auto entry = cached.value(dir).toObject();
+        if (entry.isEmpty() || qint64(entry.value("mtime").toDouble()) != mtime) {
+            // Names only, stat-ing every file is what made this slow on network mounts
+            QJsonArray found;
+            QDir d{dir};
+            for (const auto& name: d.entryList(QDir::AllEntries | QDir::NoDotAndDotDot))
+                if (GDB_PATTERN.match(name).hasMatch())
+                    found.append(d.absoluteFilePath(name));
+            entry = QJsonObject{ { "mtime", double(mtime) }, { "gdb", found } };
+            r.dirsListed++;
+        }
+        dirs.insert(dir, entry);
+        for (const auto& g: entry.value("gdb").toArray())
+            if (!r.candidates.contains(g.toString()))
+                r.candidates.append(g.toString());
+    }
+
+    if (r.dirsListed > 0 || dirs.size() != cached.size()) {
+        QFile out{cacheFile};
+        if (out.open(QFile::WriteOnly | QFile::Truncate))
+            out.write(QJsonDocument{QJsonObject{
+                { "version", conf::locator::CACHE_VERSION },
+                { "dirs", dirs },
+            }}.toJson(QJsonDocument::Compact));
+    }
+    r.elapsedNs = clock.nsecsElapsed();
+    return r;
+}
@@ -0,0 +1,48 @@
+#ifndef GDBLOCATOR_H
+#define GDBLOCATOR_H
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QStringList>
+
+template <typename T> class QFutureWatcher;
+
+// Finds gdb executables in $PATH on a worker thread. Per directory results
+// are kept on disk and a directory is listed again only when its mtime moves.
+class GdbLocator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        QStringList candidates;
+        int dirsListed = 0;
+        qint64 elapsedNs = 0;
+    };
+
+    static const QRegularExpression GDB_PATTERN;
+
+    static GdbLocator *instance();
+
+    bool isReady() const { return m_ready; }
+    const QStringList& candidates() const { return m_candidates; }
+
+public slots:
+    // Does nothing while a scan runs or once one has finished
+    void start();
+
+signals:
+    void ready(const QStringList& candidates);
+
+private:
+    explicit GdbLocator(QObject *parent = nullptr);
+
+    static Result locate(const QString& path, const QString& cacheFile);
+
+    QFutureWatcher<Result> *m_watcher;
+    QStringList m_candidates;
+    qint64 m_startNs = 0;
+    bool m_ready = false;
+};
+
+#endif // GDBLOCATOR_H
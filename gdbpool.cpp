@@ -0,0 +1,137 @@
+#include "gdbpool.h"
+#include "debugmanager.h"
+#include "elfinfo.h"
+#include "perfstats.h"
+
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+
+constexpr int GdbPool::REBUILD_SETTLE;
+
+GdbPool *GdbPool::instance()
+{
+    static GdbPool *self = nullptr;
+    if (!self)
+        self = new GdbPool;
+    return self;
+}
+
+GdbPool::GdbPool(QObject *parent) :
+    QObject(parent),
+    m_watcher(new QFileSystemWatcher(this)),
+    m_settle(new QTimer(this))
+{
+    m_settle->setSingleShot(true);
+    m_settle->setInterval(REBUILD_SETTLE);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &GdbPool::fileChanged);
+    connect(m_settle, &QTimer::timeout, this, &GdbPool::reloadChanged);
+}
+
+GdbPool::Identity GdbPool::identify(const QString &path)
+{
+    QFileInfo info{path};
+    Identity id;
+    if (!info.exists())
+        return id;
+    id.modified = info.lastModified();
+    id.size = info.size();
+    id.buildId = elf::buildId(path);
+    return id;
+}
+
+void GdbPool::prepare(const QString &gdbCommand, const QString &executable)
+{
+    auto path = QFileInfo{executable}.absoluteFilePath();
+    auto identity = identify(path);
+    if (identity.size < 0)
+        return;
+    auto it = m_entries.constFind(path);
+    if (it != m_entries.cend() && it->gdbCommand == gdbCommand && it->identity == identity &&
+            it->debug->isGdbExecuting())
+        return;
+    discard(path);
+
+    auto g = new DebugManager(this);
+    g->setGdbCommand(gdbCommand);
+    g->setGdbArgs({ path });
+    connect(g, &DebugManager::gdbProcessTerminated, this, [this, path, g]() {
+        auto it = m_entries.find(path);
+        if (it != m_entries.end() && it->debug == g)
+            m_entries.erase(it);
+        g->deleteLater();
+    });
+    m_entries.insert(path, { gdbCommand, identity, g });
+    if (!m_watcher->files().contains(path))
+        m_watcher->addPath(path);
+    perf::count("GdbPool.started");
+    g->execute();
+}
+
+DebugManager *GdbPool::take(const QString &gdbCommand, const QString &executable)
+{
+    auto path = QFileInfo{executable}.absoluteFilePath();
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || it->gdbCommand != gdbCommand || !it->debug->isReady()) {
+        perf::count("GdbPool.miss");
+        return nullptr;
+    }
+    if (it->identity != identify(path)) {
+        // Rebuilt before the watcher noticed, warm up the new one for next time
+        perf::count("GdbPool.stale");
+        prepare(gdbCommand, path);
+        return nullptr;
+    }
+    auto g = it->debug;
+    m_entries.erase(it);
+    disconnect(g, nullptr, this, nullptr);
+    g->setParent(nullptr);
+    perf::count("GdbPool.hit");
+    prepare(gdbCommand, path);
+    return g;
+}
+
+void GdbPool::clear()
+{
+    for (const auto& path: m_entries.keys())
+        discard(path);
+    if (!m_watcher->files().isEmpty())
+        m_watcher->removePaths(m_watcher->files());
+}
+
+void GdbPool::fileChanged(const QString &path)
+{
+    m_changed.insert(path);
+    m_settle->start();
+}
+
+void GdbPool::reloadChanged()
+{
+    for (const auto& path: m_changed) {
+        // Replaced files drop out of the watch list
+        if (QFileInfo::exists(path) && !m_watcher->files().contains(path))
+            m_watcher->addPath(path);
+        auto it = m_entries.constFind(path);
+        if (it != m_entries.cend() && it->identity != identify(path)) {
+            auto gdbCommand = it->gdbCommand;
+            prepare(gdbCommand, path);
+        }
+    }
+    m_changed.clear();
+}
+
+void GdbPool::discard(const QString &executable)
+{
+    auto it = m_entries.find(executable);
+    if (it == m_entries.end())
+        return;
+    auto g = it->debug;
+    m_entries.erase(it);
+    disconnect(g, nullptr, this, nullptr);
+    if (g->isGdbExecuting()) {
+        connect(g, &DebugManager::gdbProcessTerminated, g, &QObject::deleteLater);
+        g->quit();
+    } else {
+        g->deleteLater();
+    }
+}
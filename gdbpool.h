@@ -0,0 +1,68 @@
+#ifndef GDBPOOL_H
+#define GDBPOOL_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+class DebugManager;
+class QFileSystemWatcher;
+class QTimer;
+
+// Keeps a gdb per executable running with its symbols already loaded, so a
+// session start only has to run the init script. A rebuilt executable (mtime,
+// size or build-id changed) gets a fresh gdb.
+class GdbPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Linkers write the output in several steps, wait for them to settle
+    static constexpr int REBUILD_SETTLE = 500;
+
+    static GdbPool *instance();
+
+    // Starts a gdb for executable unless an up to date one is already there
+    void prepare(const QString& gdbCommand, const QString& executable);
+    // Hands over a ready gdb for the pair and keeps preparing the next one,
+    // nullptr if none matches the executable as it is on disk now
+    DebugManager *take(const QString& gdbCommand, const QString& executable);
+
+public slots:
+    void clear();
+
+private slots:
+    void fileChanged(const QString& path);
+    void reloadChanged();
+
+private:
+    struct Identity {
+        QDateTime modified;
+        qint64 size = -1;
+        QByteArray buildId;
+        bool operator==(const Identity& o) const {
+            return modified == o.modified && size == o.size && buildId == o.buildId;
+        }
+        bool operator!=(const Identity& o) const { return !(*this == o); }
+    };
+
+    struct Entry {
+        QString gdbCommand;
+        Identity identity;
+        DebugManager *debug;
+    };
+
+    explicit GdbPool(QObject *parent = nullptr);
+
+    static Identity identify(const QString& path);
+    void discard(const QString& executable);
+
+    QHash<QString, Entry> m_entries;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_settle;
+    QSet<QString> m_changed;
+};
+
+#endif // GDBPOOL_H
@@ -0,0 +1,136 @@
+#include "hoverevaluator.h"
+#include "debugmanager.h"
+
+#include <Qsci/qsciscintilla.h>
+
+#include <QRegularExpression>
+#include <QToolTip>
+
+constexpr int HoverEvaluator::DWELL_TIME;
+constexpr int HoverEvaluator::MAX_CACHED;
+
+namespace conf {
+namespace hover {
+
+// Names, member chains and simple subscripts: p->items[i].count
+const QRegularExpression EXPRESSION{R"([A-Za-z_]\w*(?:(?:\.|->)[A-Za-z_]\w*|\[\w+\])*)"};
+
+}
+}
+
+static QString quoted(const QString& expr)
+{
+    return QString{expr}.replace('\\', "\\\\").replace('"', "\\\"");
+}
+
+HoverEvaluator::HoverEvaluator(QsciScintilla *editor, QObject *parent) :
+    QObject(parent),
+    m_editor(editor)
+{
+    m_editor->SendScintilla(QsciScintilla::SCI_SETMOUSEDWELLTIME, DWELL_TIME);
+    connect(m_editor, &QsciScintilla::SCN_DWELLSTART, this, &HoverEvaluator::dwellStart);
+    connect(m_editor, &QsciScintilla::SCN_DWELLEND, this, &HoverEvaluator::cancel);
+}
+
+void HoverEvaluator::setDebugManager(DebugManager *g)
+{
+    cancel();
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_cache.clear();
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncRunning, this, &HoverEvaluator::cancel);
+    connect(g, &DebugManager::terminated, this, &HoverEvaluator::cancel);
+}
+
+void HoverEvaluator::setFrame(int thread, int level, quint64 addr)
+{
+    m_frame = QString{"%1:%2@%3"}.arg(thread).arg(level).arg(addr, 0, 16);
+    // Explicit options, the stack view no longer moves gdb's selected frame
+    m_frameOptions = thread > 0? QString{"--thread %1 --frame %2 "}.arg(thread).arg(level) : QString{};
+}
+
+void HoverEvaluator::cancel()
+{
+    if (m_pending != -1 && m_debug)
+        m_debug->cancel(m_pending);
+    m_pending = -1;
+    QToolTip::hideText();
+}
+
+QString HoverEvaluator::expressionAt(int position) const
+{
+    int line, index;
+    m_editor->lineIndexFromPosition(position, &line, &index);
+    // A selection under the mouse wins over the guessed expression
+    if (m_editor->hasSelectedText()) {
+        int l0, i0, l1, i1;
+        m_editor->getSelection(&l0, &i0, &l1, &i1);
+        if (l0 == l1 && line == l0 && index >= i0 && index <= i1)
+            return m_editor->selectedText();
+    }
+    auto text = m_editor->text(line);
+    auto it = conf::hover::EXPRESSION.globalMatch(text);
+    while (it.hasNext()) {
+        auto m = it.next();
+        if (index < m.capturedStart())
+            break;
+        if (index < m.capturedEnd()) {
+            // Up to the member under the mouse, not the whole chain
+            int end = m.capturedEnd();
+            for (int i = index; i < end; i++)
+                if (text.at(i) == '.' || text.at(i) == '-' || text.at(i) == '[') {
+                    end = i;
+                    break;
+                }
+            return text.mid(m.capturedStart(), end - m.capturedStart());
+        }
+    }
+    return {};
+}
+
+void HoverEvaluator::dwellStart(int position, int x, int y)
+{
+    cancel();
+    if (position < 0 || !m_debug || !m_debug->isGdbExecuting() || m_debug->isInferiorRunning())
+        return;
+    auto expr = expressionAt(position);
+    if (expr.isEmpty())
+        return;
+    if (m_generation != m_debug->stopGeneration()) {
+        m_generation = m_debug->stopGeneration();
+        m_cache.clear();
+    }
+    auto pos = m_editor->viewport()->mapToGlobal(QPoint{x, y});
+    auto key = expr + '\n' + m_frame;
+    auto it = m_cache.constFind(key);
+    if (it != m_cache.cend()) {
+        show(expr, *it, pos);
+        return;
+    }
+    if (m_cache.size() >= MAX_CACHED)
+        m_cache.clear();
+    int generation = m_generation;
+    auto cmd = QString{"-data-evaluate-expression %1\"%2\""}.arg(m_frameOptions, quoted(expr));
+    auto done = [this, expr, key, pos, generation](const QString& value) {
+        m_pending = -1;
+        if (generation != m_generation)
+            return;
+        m_cache.insert(key, value);
+        show(expr, value, pos);
+    };
+    // Interactive: the user is waiting for this one
+    m_pending = m_debug->enqueue(cmd, DebugManager::Priority_t::Interactive, [done](const QVariant& r) {
+        done(r.toMap().value("value").toString());
+    }, [done](const QVariant&) {
+        done({});
+    });
+}
+
+void HoverEvaluator::show(const QString &expr, const QString &value, const QPoint &pos)
+{
+    if (!value.isEmpty())
+        QToolTip::showText(pos, QString{"%1 = %2"}.arg(expr, value), m_editor);
+}
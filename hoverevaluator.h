@@ -0,0 +1,47 @@
+#ifndef HOVEREVALUATOR_H
+#define HOVEREVALUATOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+
+class DebugManager;
+class QsciScintilla;
+
+// Evaluates the expression under the mouse after it rests on the editor.
+// Values are memoized per (expression, frame, stop generation); moving on
+// or resuming drops the request still in flight.
+class HoverEvaluator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DWELL_TIME = 400;
+    static constexpr int MAX_CACHED = 512;
+
+    explicit HoverEvaluator(QsciScintilla *editor, QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    // Frame the next evaluations run in, part of the memoization key
+    void setFrame(int thread, int level, quint64 addr);
+    void cancel();
+
+private slots:
+    void dwellStart(int position, int x, int y);
+
+private:
+    QString expressionAt(int position) const;
+    void show(const QString& expr, const QString& value, const QPoint& pos);
+
+    QsciScintilla *m_editor;
+    DebugManager *m_debug = nullptr;
+    QString m_frame;
+    QString m_frameOptions;
+    int m_generation = -1;
+    QHash<QString, QString> m_cache;
+    int m_pending = -1;
+};
+
+#endif // HOVEREVALUATOR_H
@@ -0,0 +1,248 @@
+#include "inlinevalues.h"
+#include "perfstats.h"
+
+#include <Qsci/qsciscintilla.h>
+#include <Qsci/qscistyle.h>
+
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QSet>
+#include <QTimer>
+
+constexpr int InlineValues::CONTEXT_LINES;
+constexpr int InlineValues::MAX_PER_LINE;
+constexpr int InlineValues::MAX_EVALUATIONS;
+constexpr int InlineValues::MAX_VALUE_LENGTH;
+constexpr int InlineValues::SCROLL_SETTLE;
+
+namespace conf {
+namespace inlinevalues {
+
+const auto FG = QColor("#ff5f7f9f");
+const auto BG = QColor("#fff4f7fa");
+
+const QSet<QString> KEYWORDS{
+    "alignas", "alignof", "auto", "bool", "break", "case", "catch", "char", "class", "const",
+    "constexpr", "const_cast", "continue", "decltype", "default", "delete", "do", "double",
+    "dynamic_cast", "else", "enum", "explicit", "extern", "false", "float", "for", "friend",
+    "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "nullptr",
+    "operator", "private", "protected", "public", "register", "reinterpret_cast", "return",
+    "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+    "template", "this", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+    "unsigned", "using", "virtual", "void", "volatile", "while", "NULL",
+};
+
+// Plain names and member chains such as a.b->c
+const QRegularExpression IDENTIFIER{R"([A-Za-z_]\w*(?:(?:\.|->)[A-Za-z_]\w*)*)"};
+
+}
+}
+
+static QString quoted(const QString& expr)
+{
+    return QString{expr}.replace('\\', "\\\\").replace('"', "\\\"");
+}
+
+// Blanks string/char literals and cuts line comments, so their contents are
+// not taken for identifiers. Block comments spanning lines are not tracked.
+static QString codeOnly(const QString& text)
+{
+    QString out = text;
+    QChar quote;
+    for (int i = 0; i < out.size(); i++) {
+        auto c = out.at(i);
+        if (!quote.isNull()) {
+            if (c == '\\')
+                out[i++] = ' ';
+            else if (c == quote)
+                quote = QChar{};
+            if (i < out.size())
+                out[i] = ' ';
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+            out[i] = ' ';
+        } else if (c == '/' && i + 1 < out.size() && out.at(i + 1) == '/') {
+            out.truncate(i);
+            break;
+        }
+    }
+    return out;
+}
+
+InlineValues::InlineValues(QsciScintilla *editor, QObject *parent) :
+    QObject(parent),
+    m_editor(editor),
+    m_style(new QsciStyle(-1, "Inline value", conf::inlinevalues::FG, conf::inlinevalues::BG,
+                          editor->font())),
+    m_timer(new QTimer(this))
+{
+    m_style->setFont(QFont{editor->font().family(), editor->font().pointSize(), -1, true});
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(SCROLL_SETTLE);
+    connect(m_timer, &QTimer::timeout, this, &InlineValues::update);
+    // Scrolling changes what is visible, requests for lines that left the
+    // screen are dropped before the next batch goes out
+    connect(m_editor->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        if (m_line < 0)
+            return;
+        cancelPending();
+        m_timer->start();
+    });
+}
+
+InlineValues::~InlineValues()
+{
+    delete m_style;
+}
+
+void InlineValues::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    clear();
+    m_debug = g;
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncRunning, this, &InlineValues::clear);
+    connect(g, &DebugManager::terminated, this, &InlineValues::clear);
+}
+
+void InlineValues::setLocals(const QList<gdb::Variable> &locals)
+{
+    m_locals.clear();
+    for (const auto& v: locals)
+        if (!v.value.isEmpty())
+            m_locals.insert(v.name, v.value);
+    m_timer->start();
+}
+
+void InlineValues::setCurrentLine(const QString &fullpath, int line)
+{
+    m_file = fullpath;
+    m_line = line - 1;
+    m_timer->start();
+}
+
+void InlineValues::setFrame(int thread, int level)
+{
+    auto options = thread > 0? QString{"--thread %1 --frame %2 "}.arg(thread).arg(level) : QString{};
+    if (options == m_frameOptions)
+        return;
+    // Values evaluated in another frame do not apply here
+    cancelPending();
+    m_values.clear();
+    m_frameOptions = options;
+    m_timer->start();
+}
+
+void InlineValues::clear()
+{
+    cancelPending();
+    m_timer->stop();
+    m_line = -1;
+    m_locals.clear();
+    m_values.clear();
+    m_shown.clear();
+    m_editor->clearAnnotations();
+}
+
+void InlineValues::cancelPending()
+{
+    if (m_debug)
+        for (auto token: m_pending)
+            m_debug->cancel(token);
+    m_pending.clear();
+}
+
+QStringList InlineValues::scanLine(const QString &text) const
+{
+    QStringList names;
+    auto code = codeOnly(text);
+    auto it = conf::inlinevalues::IDENTIFIER.globalMatch(code);
+    while (it.hasNext() && names.size() < MAX_PER_LINE) {
+        auto m = it.next();
+        auto name = m.captured();
+        int after = m.capturedEnd();
+        while (after < code.size() && code.at(after).isSpace())
+            after++;
+        // Calls and types in declarations are not values
+        if (after < code.size() && code.at(after) == '(')
+            continue;
+        if (m.capturedStart() > 0 && code.at(m.capturedStart() - 1) == ':')
+            continue;
+        if (conf::inlinevalues::KEYWORDS.contains(name) || names.contains(name))
+            continue;
+        names.append(name);
+    }
+    return names;
+}
+
+void InlineValues::update()
+{
+    PERF_SCOPE("InlineValues::update");
+    if (!m_debug || m_line < 0 || m_editor->windowFilePath() != m_file || m_debug->isInferiorRunning())
+        return;
+    if (m_generation != m_debug->stopGeneration()) {
+        m_generation = m_debug->stopGeneration();
+        m_values.clear();
+    }
+    int first = qMax(m_editor->firstVisibleLine(), m_line - CONTEXT_LINES);
+    int last = qMin(m_editor->firstVisibleLine() + m_editor->linesOnScreen(), m_line);
+    m_shown.clear();
+    QStringList wanted;
+    for (int line = first; line <= last; line++) {
+        auto names = scanLine(m_editor->text(line));
+        if (names.isEmpty())
+            continue;
+        m_shown.insert(line, names);
+        for (const auto& n: names)
+            if (!m_locals.contains(n) && !m_values.contains(n) && !wanted.contains(n))
+                wanted.append(n);
+    }
+    annotate();
+
+    int generation = m_generation;
+    for (const auto& expr: wanted) {
+        if (m_pending.size() >= MAX_EVALUATIONS)
+            break;
+        if (m_pending.contains(expr))
+            continue;
+        auto cmd = QString{"-data-evaluate-expression %1\"%2\""}.arg(m_frameOptions, quoted(expr));
+        auto options = m_frameOptions;
+        auto done = [this, expr, generation, options](const QString& value) {
+            m_pending.remove(expr);
+            if (generation != m_generation || options != m_frameOptions)
+                return;
+            m_values.insert(expr, value);
+            annotate();
+        };
+        m_pending.insert(expr, m_debug->enqueue(cmd, DebugManager::Priority_t::Background,
+                                                [done](const QVariant& r) {
+            done(r.toMap().value("value").toString());
+        }, [this, expr, done](const QVariant& r) {
+            // Dropped, not failed: leave it to be asked again
+            if (DebugManager::isCancelled(r))
+                m_pending.remove(expr);
+            else
+                done({});
+        }));
+    }
+}
+
+void InlineValues::annotate()
+{
+    m_editor->clearAnnotations();
+    for (auto it = m_shown.cbegin(); it != m_shown.cend(); ++it) {
+        QStringList parts;
+        for (const auto& name: it.value()) {
+            auto value = m_locals.value(name, m_values.value(name));
+            if (value.isEmpty())
+                continue;
+            if (value.size() > MAX_VALUE_LENGTH)
+                value = value.left(MAX_VALUE_LENGTH) + "...";
+            parts.append(QString{"%1 = %2"}.arg(name, value));
+        }
+        if (!parts.isEmpty())
+            m_editor->annotate(it.key(), parts.join("   "), *m_style);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef INLINEVALUES_H
+#define INLINEVALUES_H
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+#include "debugmanager.h"
+
+class QsciScintilla;
+class QsciStyle;
+class QTimer;
+
+// Shows values of the identifiers on the lines up to the current one as
+// editor annotations. Only lines on screen are scanned. Locals come from
+// the snapshot the context refresh fetched already. Anything else is
+// evaluated in one capped batch that is dropped on scroll or resume.
+class InlineValues : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Lines above the current one that may get annotations
+    static constexpr int CONTEXT_LINES = 30;
+    static constexpr int MAX_PER_LINE = 4;
+    // Evaluations in flight for one update, the rest waits for scrolling
+    static constexpr int MAX_EVALUATIONS = 16;
+    static constexpr int MAX_VALUE_LENGTH = 40;
+    static constexpr int SCROLL_SETTLE = 100;
+
+    explicit InlineValues(QsciScintilla *editor, QObject *parent = nullptr);
+    ~InlineValues();
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    void setLocals(const QList<gdb::Variable>& locals);
+    void setCurrentLine(const QString& fullpath, int line);
+    void setFrame(int thread, int level);
+    void clear();
+
+private slots:
+    void update();
+
+private:
+    QStringList scanLine(const QString& text) const;
+    void cancelPending();
+    void annotate();
+
+    QsciScintilla *m_editor;
+    QsciStyle *m_style;
+    DebugManager *m_debug = nullptr;
+    QTimer *m_timer;
+    QString m_file;
+    int m_line = -1;
+    QString m_frameOptions;
+    int m_generation = -1;
+    QHash<QString, QString> m_locals;
+    // Evaluated expressions of the current stop, failures stored as empty
+    QHash<QString, QString> m_values;
+    QHash<QString, int> m_pending;
+    QHash<int, QStringList> m_shown;
+};
+
+#endif // INLINEVALUES_H
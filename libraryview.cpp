@@ -0,0 +1,251 @@
+#include "libraryview.h"
+
+#include <QCheckBox>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QTimer>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+constexpr int LibraryModel::UPDATE_INTERVAL;
+
+LibraryModel::LibraryModel(QObject *parent) :
+    QAbstractTableModel(parent),
+    m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(UPDATE_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &LibraryModel::reload);
+}
+
+void LibraryModel::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_symbolsLoaded.clear();
+    // Library ids of another session say nothing about these rows
+    beginResetModel();
+    m_rows.clear();
+    endResetModel();
+    reload();
+    if (!g)
+        return;
+    // A storm of loads becomes one reset per interval, not one per record
+    connect(g, &DebugManager::librariesChanged, this, [this]() {
+        if (!m_timer->isActive())
+            m_timer->start();
+    });
+    connect(g, &DebugManager::started, this, [this]() {
+        m_symbolsLoaded.clear();
+        reload();
+    });
+}
+
+void LibraryModel::markSymbolsLoaded(const QString &id)
+{
+    m_symbolsLoaded.insert(id);
+    for (int row = 0; row < m_rows.size(); row++)
+        if (m_rows.at(row).id == id)
+            emit dataChanged(index(row, Symbols), index(row, Symbols));
+}
+
+void LibraryModel::reload()
+{
+    m_timer->stop();
+    auto libs = m_debug? m_debug->libraries() : QVector<gdb::Library>{};
+    // Loads only append, so rows are inserted and views keep their selection
+    // and scroll position; anything else, an unload above all, resets
+    bool appended = libs.size() >= m_rows.size();
+    for (int row = 0; appended && row < m_rows.size(); row++)
+        appended = libs.at(row).id == m_rows.at(row).id;
+    if (!appended) {
+        beginResetModel();
+        m_rows = libs;
+        endResetModel();
+        return;
+    }
+    for (int row = 0; row < m_rows.size(); row++) {
+        const auto& lib = libs.at(row);
+        auto& old = m_rows[row];
+        if (lib.symbolsLoaded != old.symbolsLoaded || lib.from != old.from || lib.to != old.to ||
+                lib.targetName != old.targetName || lib.hostName != old.hostName) {
+            old = lib;
+            emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+        }
+    }
+    if (libs.size() > m_rows.size()) {
+        beginInsertRows({}, m_rows.size(), libs.size() - 1);
+        m_rows = libs;
+        endInsertRows();
+    }
+}
+
+int LibraryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid()? 0 : m_rows.size();
+}
+
+int LibraryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid()? 0 : COLUMN_COUNT;
+}
+
+QVariant LibraryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return {};
+    const auto& lib = m_rows.at(index.row());
+    bool symbols = lib.symbolsLoaded || m_symbolsLoaded.contains(lib.id);
+    // Sorting goes through Qt::UserRole, so addresses compare as numbers
+    if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case Name: return QFileInfo{lib.targetName}.fileName();
+        case Symbols: return symbols;
+        case From: return lib.from;
+        case To: return lib.to;
+        case Path: return lib.targetName;
+        }
+    } else if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case Name: return QFileInfo{lib.targetName}.fileName();
+        case Symbols: return symbols? tr("yes") : tr("no");
+        case From: return lib.from? QString{"0x%1"}.arg(lib.from, 0, 16) : QString{};
+        case To: return lib.to? QString{"0x%1"}.arg(lib.to, 0, 16) : QString{};
+        case Path: return lib.targetName;
+        }
+    } else if (role == Qt::ToolTipRole) {
+        return lib.hostName;
+    }
+    return {};
+}
+
+QVariant LibraryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return {};
+    switch (section) {
+    case Name: return tr("Library");
+    case Symbols: return tr("Symbols");
+    case From: return tr("From");
+    case To: return tr("To");
+    case Path: return tr("Path");
+    }
+    return {};
+}
+
+LibraryView::LibraryView(QWidget *parent) :
+    QWidget(parent),
+    m_model(new LibraryModel(this)),
+    m_proxy(new QSortFilterProxyModel(this)),
+    m_view(new QTableView(this)),
+    m_filter(new QLineEdit(this)),
+    m_selectedOnly(new QCheckBox(tr("Selected only"), this)),
+    m_count(new QLabel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    auto buttonLoad = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    m_filter->setPlaceholderText(tr("Filter libraries"));
+    buttonLoad->setIcon(QIcon{":/images/document-open.svg"});
+    buttonLoad->setToolTip(tr("Load symbols of the selected libraries"));
+    m_selectedOnly->setToolTip(tr("Do not read symbols of libraries as they load, "
+                                  "which also keeps their sources and functions out of the lists"));
+    toolbar->addWidget(m_filter);
+    toolbar->addWidget(m_selectedOnly);
+    toolbar->addWidget(buttonLoad);
+    toolbar->addWidget(m_count);
+    layout->addLayout(toolbar);
+    layout->addWidget(m_view);
+
+    m_proxy->setSourceModel(m_model);
+    m_proxy->setSortRole(Qt::UserRole);
+    m_proxy->setFilterKeyColumn(LibraryModel::Path);
+    m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_view->setModel(m_proxy);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(LibraryModel::Name, Qt::AscendingOrder);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_view->setWordWrap(false);
+    // Fixed row height keeps the view from measuring thousands of rows
+    m_view->verticalHeader()->hide();
+    m_view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_view->verticalHeader()->setDefaultSectionSize(m_view->fontMetrics().height() + 4);
+    m_view->horizontalHeader()->setStretchLastSection(true);
+
+    connect(m_filter, &QLineEdit::textChanged, m_proxy, &QSortFilterProxyModel::setFilterFixedString);
+    connect(buttonLoad, &QToolButton::clicked, this, &LibraryView::loadSelectedSymbols);
+    connect(m_selectedOnly, &QCheckBox::toggled, this, &LibraryView::setSelectedOnly);
+    connect(m_model, &QAbstractItemModel::modelReset, this, &LibraryView::updateCount);
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, &LibraryView::updateCount);
+    updateCount();
+}
+
+void LibraryView::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_model->setDebugManager(g);
+    if (!g)
+        return;
+    connect(g, &DebugManager::started, this, [this]() {
+        if (m_selectedOnly->isChecked())
+            setSelectedOnly(true);
+    });
+}
+
+// sharedlibrary takes a POSIX basic regex, where GNU reads \+ and \? as
+// operators, so only the BRE metacharacters may be escaped
+static QString basicRegexEscape(const QString& s)
+{
+    QString out;
+    out.reserve(s.size() * 2);
+    for (auto c: s) {
+        switch (c.unicode()) {
+        case '.': case '[': case ']': case '*': case '^': case '$': case '\\':
+            out += '\\';
+            break;
+        }
+        out += c;
+    }
+    return out;
+}
+
+void LibraryView::loadSelectedSymbols()
+{
+    if (!m_debug || !m_debug->isGdbExecuting())
+        return;
+    for (const auto& idx: m_view->selectionModel()->selectedRows()) {
+        auto lib = m_model->library(m_proxy->mapToSource(idx).row());
+        auto re = QString{"^%1$"}.arg(basicRegexEscape(lib.targetName));
+        auto cmd = QString{"-interpreter-exec console \"sharedlibrary %1\""}
+                .arg(re.replace('\\', "\\\\").replace('"', "\\\""));
+        auto id = lib.id;
+        m_debug->enqueue(cmd, DebugManager::Priority_t::Interactive, [this, id](const QVariant&) {
+            m_model->markSymbolsLoaded(id);
+        });
+    }
+}
+
+void LibraryView::setSelectedOnly(bool on)
+{
+    // gdb then reads symbols only when asked through sharedlibrary, which is
+    // what keeps source lists and symbol queries down to chosen libraries
+    if (m_debug && m_debug->isGdbExecuting())
+        m_debug->command(QString{"-gdb-set auto-solib-add %1"}.arg(on? "off" : "on"));
+}
+
+void LibraryView::updateCount()
+{
+    m_count->setText(tr("%1 libraries").arg(m_model->rowCount()));
+}
@@ -0,0 +1,73 @@
+#ifndef LIBRARYVIEW_H
+#define LIBRARYVIEW_H
+
+#include <QAbstractTableModel>
+#include <QSet>
+#include <QVector>
+#include <QWidget>
+
+#include "debugmanager.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QSortFilterProxyModel;
+class QTableView;
+class QTimer;
+
+// Snapshot of DebugManager::libraries(), refreshed at most every
+// UPDATE_INTERVAL while load notifications keep coming
+class LibraryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column_t { Name, Symbols, From, To, Path, COLUMN_COUNT };
+    static constexpr int UPDATE_INTERVAL = 100;
+
+    explicit LibraryModel(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+    const gdb::Library& library(int row) const { return m_rows.at(row); }
+    void markSymbolsLoaded(const QString& id);
+
+    virtual int rowCount(const QModelIndex& parent = {}) const;
+    virtual int columnCount(const QModelIndex& parent = {}) const;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private slots:
+    void reload();
+
+private:
+    DebugManager *m_debug = nullptr;
+    QTimer *m_timer;
+    QVector<gdb::Library> m_rows;
+    QSet<QString> m_symbolsLoaded;
+};
+
+class LibraryView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LibraryView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+private slots:
+    void loadSelectedSymbols();
+    void setSelectedOnly(bool on);
+    void updateCount();
+
+private:
+    DebugManager *m_debug = nullptr;
+    LibraryModel *m_model;
+    QSortFilterProxyModel *m_proxy;
+    QTableView *m_view;
+    QLineEdit *m_filter;
+    QCheckBox *m_selectedOnly;
+    QLabel *m_count;
+};
+
+#endif // LIBRARYVIEW_H
@@ -0,0 +1,336 @@
+#include "livesampler.h"
+#include "debugmanager.h"
+
+#include <QTimer>
+#include <QVariant>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+constexpr int SampleRing::DEFAULT_CAPACITY;
+constexpr int LiveSampler::WINDOW_SECONDS;
+
+namespace conf {
+namespace sampler {
+
+// Gap up to which two expressions are read with a single request
+constexpr quint64 MERGE_GAP = 32;
+constexpr int MAX_SPAN = 4096;
+// Approximate MI/RSP framing cost of one read, on top of two hex chars per byte
+constexpr int REQUEST_OVERHEAD = 64;
+
+}
+}
+
+SampleRing::SampleRing(int capacity) : m_data(capacity)
+{
+}
+
+void SampleRing::setDecimation(int factor)
+{
+    factor = qMax(1, factor);
+    if (factor != m_factor) {
+        m_factor = factor;
+        m_accCount = 0;
+        m_accSum = 0;
+    }
+}
+
+void SampleRing::push(double t, double v)
+{
+    m_accSum += v;
+    if (++m_accCount < m_factor)
+        return;
+    m_data[m_head] = QPointF{t, m_accSum / m_accCount};
+    m_head = (m_head + 1) % m_data.size();
+    m_count = qMin(m_count + 1, m_data.size());
+    m_accCount = 0;
+    m_accSum = 0;
+}
+
+void SampleRing::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_accCount = 0;
+    m_accSum = 0;
+}
+
+QPointF SampleRing::at(int i) const
+{
+    int oldest = (m_head - m_count + m_data.size()) % m_data.size();
+    return m_data.at((oldest + i) % m_data.size());
+}
+
+static QString quoted(const QString& expr)
+{
+    return QString{expr}.replace('\\', "\\\\").replace('"', "\\\"");
+}
+
+static LiveSampler::Channel::Kind_t kindOfType(const QString& type)
+{
+    if (type.contains("float") || type.contains("double"))
+        return LiveSampler::Channel::Float;
+    if (type.contains("unsigned") || type.contains("uint") || type.contains("size_t") || type == "bool")
+        return LiveSampler::Channel::Unsigned;
+    return LiveSampler::Channel::Signed;
+}
+
+LiveSampler::LiveSampler(QObject *parent) :
+    QObject(parent),
+    m_timer(new QTimer(this))
+{
+    m_clock.start();
+    connect(m_timer, &QTimer::timeout, this, &LiveSampler::tick);
+}
+
+void LiveSampler::setDebugManager(DebugManager *g)
+{
+    stop();
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncStopped, this, &LiveSampler::resolvePending);
+    connect(g, &DebugManager::terminated, this, [this]() {
+        stop();
+        for (auto& c: m_channels)
+            c.resolved = false;
+        rebuildSpans();
+    });
+}
+
+double LiveSampler::effectiveRate() const
+{
+    return m_timer->interval() > 0? 1000.0 / m_timer->interval() : m_rate;
+}
+
+void LiveSampler::addExpression(const QString &expr)
+{
+    if (expr.isEmpty() || indexOf(expr) != -1)
+        return;
+    Channel c;
+    c.expr = expr;
+    m_channels.append(c);
+    if (m_debug && m_debug->isGdbExecuting() && !m_debug->isInferiorRunning())
+        resolve(expr);
+    emit channelsChanged();
+}
+
+void LiveSampler::removeExpression(const QString &expr)
+{
+    int idx = indexOf(expr);
+    if (idx == -1)
+        return;
+    m_channels.removeAt(idx);
+    rebuildSpans();
+    emit channelsChanged();
+}
+
+void LiveSampler::setRate(double hz)
+{
+    m_rate = qMax(0.1, hz);
+    updateInterval();
+}
+
+void LiveSampler::setBandwidthLimit(int bytesPerSecond)
+{
+    m_bandwidth = qMax(64, bytesPerSecond);
+    updateInterval();
+}
+
+void LiveSampler::start()
+{
+    if (m_active || !m_debug || !m_debug->isGdbExecuting())
+        return;
+    // An all-stop gdb refuses memory reads while the inferior runs
+    if (!m_debug->isNonStop()) {
+        emit error(tr("Live sampling needs a non-stop session (set non-stop on)"));
+        return;
+    }
+    m_active = true;
+    m_outstanding = 0;
+    updateInterval();
+    m_timer->start();
+    emit activeChanged(true);
+}
+
+void LiveSampler::stop()
+{
+    m_timer->stop();
+    m_outstanding = 0;
+    if (m_active) {
+        m_active = false;
+        emit activeChanged(false);
+    }
+}
+
+void LiveSampler::tick()
+{
+    // Never stack sweeps: a slow link lowers the rate instead of growing a queue
+    if (m_outstanding > 0 || m_spans.isEmpty())
+        return;
+    double t = m_clock.elapsed() / 1000.0;
+    int generation = m_spanGeneration;
+    for (const auto& span: m_spans) {
+        m_outstanding++;
+        auto cmd = QString{"-data-read-memory-bytes 0x%1 %2"}.arg(span.addr, 0, 16).arg(span.len);
+        m_debug->enqueue(cmd, DebugManager::Priority_t::Refresh, [this, span, t, generation](const QVariant& r) {
+            if (!m_active)
+                return;
+            if (generation != m_spanGeneration) {
+                if (--m_outstanding == 0)
+                    emit sampled();
+                return;
+            }
+            for (const auto& e: r.toMap().value("memory").toList()) {
+                auto m = e.toMap();
+                // gdb splits the span around unreadable bytes, begin is absolute
+                auto begin = m.value("begin").toString().toULongLong(nullptr, 16);
+                storeSpan(span, begin, QByteArray::fromHex(m.value("contents").toString().toLatin1()), t);
+            }
+            if (--m_outstanding == 0)
+                emit sampled();
+        }, [this](const QVariant& r) {
+            m_outstanding = qMax(0, m_outstanding - 1);
+            if (!m_active)
+                return;
+            stop();
+            emit error(tr("Target does not allow background memory reads: %1")
+                       .arg(r.toMap().value("msg").toString()));
+        });
+    }
+}
+
+void LiveSampler::resolvePending()
+{
+    for (const auto& c: m_channels)
+        if (!c.resolved && !c.failed)
+            resolve(c.expr);
+}
+
+void LiveSampler::resolve(const QString &expr)
+{
+    auto q = quoted(expr);
+    auto fail = [this, expr](const QVariant& r) {
+        int idx = indexOf(expr);
+        if (idx != -1)
+            m_channels[idx].failed = true;
+        emit error(tr("Cannot sample %1: %2").arg(expr, r.toMap().value("msg").toString()));
+    };
+    m_debug->commandAndResponse(QString{"-var-create - * \"%1\""}.arg(q), [this, expr, q, fail](const QVariant& r) {
+        auto var = r.toMap();
+        auto kind = kindOfType(var.value("type").toString());
+        m_debug->command(QString{"-var-delete %1"}.arg(var.value("name").toString()));
+        auto cmd = QString{"-data-evaluate-expression \"sizeof(%1)\""}.arg(q);
+        m_debug->commandAndResponse(cmd, [this, expr, q, kind, fail](const QVariant& r) {
+            int size = r.toMap().value("value").toString().toInt();
+            auto cmd = QString{"-data-evaluate-expression \"(unsigned long long)&(%1)\""}.arg(q);
+            m_debug->commandAndResponse(cmd, [this, expr, kind, size](const QVariant& r) {
+                int idx = indexOf(expr);
+                if (idx == -1)
+                    return;
+                bool ok = false;
+                auto addr = r.toMap().value("value").toString().toULongLong(&ok, 0);
+                if (!ok || size <= 0 || size > 8) {
+                    m_channels[idx].failed = true;
+                    emit error(tr("Cannot sample %1: not a scalar in memory").arg(expr));
+                    return;
+                }
+                auto& c = m_channels[idx];
+                c.addr = addr;
+                c.size = size;
+                c.kind = (kind == Channel::Float && size != 4 && size != 8)? Channel::Signed : kind;
+                c.resolved = true;
+                rebuildSpans();
+                emit channelsChanged();
+            }, fail);
+        }, fail);
+    }, fail);
+}
+
+void LiveSampler::rebuildSpans()
+{
+    QList<int> order;
+    for (int i = 0; i < m_channels.size(); i++)
+        if (m_channels.at(i).resolved)
+            order.append(i);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_channels.at(a).addr < m_channels.at(b).addr;
+    });
+    m_spans.clear();
+    m_spanGeneration++;
+    for (auto i: order) {
+        const auto& c = m_channels.at(i);
+        if (!m_spans.isEmpty()) {
+            auto& last = m_spans.last();
+            auto end = qMax(last.addr + quint64(last.len), c.addr + quint64(c.size));
+            if (c.addr <= last.addr + quint64(last.len) + conf::sampler::MERGE_GAP &&
+                end - last.addr <= quint64(conf::sampler::MAX_SPAN)) {
+                last.len = int(end - last.addr);
+                last.channels.append(i);
+                continue;
+            }
+        }
+        m_spans.append({ c.addr, c.size, { i } });
+    }
+    updateInterval();
+}
+
+void LiveSampler::updateInterval()
+{
+    int bytesPerSweep = 0;
+    for (const auto& span: m_spans)
+        bytesPerSweep += 2 * span.len + conf::sampler::REQUEST_OVERHEAD;
+    double intervalMs = qMax(1000.0 / m_rate, 1000.0 * bytesPerSweep / m_bandwidth);
+    m_timer->setInterval(qMax(1, int(std::ceil(intervalMs))));
+    int factor = int(std::ceil(effectiveRate() * WINDOW_SECONDS / SampleRing::DEFAULT_CAPACITY));
+    for (auto& c: m_channels)
+        c.ring.setDecimation(factor);
+}
+
+void LiveSampler::storeSpan(const Span &span, quint64 begin, const QByteArray &bytes, double t)
+{
+    for (auto i: span.channels) {
+        if (i >= m_channels.size())
+            continue;
+        auto& c = m_channels[i];
+        // Compared in 64 bits, a far address must not wrap into the block
+        if (c.addr < begin || c.addr - begin + quint64(c.size) > quint64(bytes.size()))
+            continue;
+        int offset = int(c.addr - begin);
+        // Targets of interest (Cortex-M, RISC-V, x86) are little endian
+        quint64 raw = 0;
+        for (int b = c.size - 1; b >= 0; b--)
+            raw = (raw << 8) | uchar(bytes.at(offset + b));
+        double v;
+        if (c.kind == Channel::Float && c.size == 4) {
+            float f;
+            auto bits = quint32(raw);
+            std::memcpy(&f, &bits, sizeof(f));
+            v = f;
+        } else if (c.kind == Channel::Float) {
+            double d;
+            std::memcpy(&d, &raw, sizeof(d));
+            v = d;
+        } else if (c.kind == Channel::Signed && c.size < 8) {
+            auto shift = 64 - c.size * 8;
+            v = double(qint64(raw << shift) >> shift);
+        } else if (c.kind == Channel::Signed) {
+            v = double(qint64(raw));
+        } else {
+            v = double(raw);
+        }
+        c.ring.push(t, v);
+    }
+}
+
+int LiveSampler::indexOf(const QString &expr) const
+{
+    for (int i = 0; i < m_channels.size(); i++)
+        if (m_channels.at(i).expr == expr)
+            return i;
+    return -1;
+}
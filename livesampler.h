@@ -0,0 +1,111 @@
+#ifndef LIVESAMPLER_H
+#define LIVESAMPLER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointF>
+#include <QVector>
+
+class DebugManager;
+class QTimer;
+
+class SampleRing
+{
+public:
+    static constexpr int DEFAULT_CAPACITY = 1024;
+
+    explicit SampleRing(int capacity = DEFAULT_CAPACITY);
+
+    // Average every factor incoming samples into one stored point
+    void setDecimation(int factor);
+    int decimation() const { return m_factor; }
+
+    void push(double t, double v);
+    void clear();
+
+    int size() const { return m_count; }
+    int capacity() const { return m_data.size(); }
+    QPointF at(int i) const;
+
+private:
+    QVector<QPointF> m_data;
+    int m_head = 0;
+    int m_count = 0;
+    int m_factor = 1;
+    int m_accCount = 0;
+    double m_accSum = 0;
+};
+
+class LiveSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int WINDOW_SECONDS = 60;
+
+    struct Channel {
+        enum Kind_t { Signed, Unsigned, Float };
+        QString expr;
+        quint64 addr = 0;
+        int size = 0;
+        Kind_t kind = Signed;
+        bool resolved = false;
+        bool failed = false;
+        SampleRing ring;
+    };
+
+    explicit LiveSampler(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+    const QList<Channel>& channels() const { return m_channels; }
+    bool isActive() const { return m_active; }
+    double rate() const { return m_rate; }
+    int bandwidthLimit() const { return m_bandwidth; }
+    double effectiveRate() const;
+
+public slots:
+    void addExpression(const QString& expr);
+    void removeExpression(const QString& expr);
+    void setRate(double hz);
+    void setBandwidthLimit(int bytesPerSecond);
+    void start();
+    void stop();
+
+signals:
+    void sampled();
+    void channelsChanged();
+    void activeChanged(bool active);
+    void error(const QString& msg);
+
+private slots:
+    void tick();
+    void resolvePending();
+
+private:
+    struct Span {
+        quint64 addr;
+        int len;
+        QList<int> channels;
+    };
+
+    void resolve(const QString& expr);
+    void rebuildSpans();
+    void updateInterval();
+    void storeSpan(const Span& span, quint64 begin, const QByteArray& bytes, double t);
+    int indexOf(const QString& expr) const;
+
+    DebugManager *m_debug = nullptr;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    QList<Channel> m_channels;
+    QList<Span> m_spans;
+    // Bumped by rebuildSpans, replies of older sweeps hold stale indices
+    int m_spanGeneration = 0;
+    double m_rate = 10.0;
+    int m_bandwidth = 4096;
+    int m_outstanding = 0;
+    bool m_active = false;
+};
+
+#endif // LIVESAMPLER_H
@@ -1,13 +1,30 @@
+#include "batchrunner.h"
 #include "debugmanager.h"
+#include "gdblocator.h"
 #include "mainwidget.h"
+#include "perfstats.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QScopedPointer>
+#include <QThread>
 #include <QTimer>
 
+static bool isBatch(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+        if (qstrcmp(argv[i], "--batch") == 0)
+            return true;
+    return false;
+}
+
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    // Batch mode must work without a display, so no QApplication there
+    bool batch = isBatch(argc, argv);
+    // Starts the statistics clock, startup probes are relative to it
+    perf::Stats::instance();
+    QScopedPointer<QCoreApplication> a(batch? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
     QApplication::setApplicationName("gdbfront");
     QApplication::setApplicationDisplayName(QApplication::tr("GDBFront"));
     QApplication::setApplicationVersion("0.1");
@@ -22,19 +39,46 @@ int main(int argc, char *argv[])
         { "init", QApplication::tr("Init script file"), "init" },
         { "gdb", QApplication::tr("GDB Executable name"), "gdb" },
         { "start", QApplication::tr("Automatic start session debug") },
-        { "gdbcmd", QApplication::tr("GDB Command"), "gdbcmd" }
+        { "gdbcmd", QApplication::tr("GDB Command"), "gdbcmd" },
+        { "perf", QApplication::tr("Record performance statistics from startup") },
+        { "batch", QApplication::tr("Analyze core files without GUI and print a JSON report") },
+        { "core", QApplication::tr("Core file to analyze in batch mode (repeatable)"), "core" },
+        { "expr", QApplication::tr("Expression to evaluate in the crashing thread (repeatable)"), "expr" },
+        { "output", QApplication::tr("Batch report file, standard output if not given"), "output" },
+        { "jobs", QApplication::tr("Parallel gdb instances in batch mode"), "jobs",
+          QString::number(QThread::idealThreadCount()) },
+        { "timeout", QApplication::tr("Seconds allowed per core file in batch mode"), "timeout", "120" },
     });
-    parser.process(a);
+    parser.process(*a);
+
+    if (parser.isSet("perf"))
+        perf::Stats::instance()->setEnabled(true);
 
     QStringList gdbArgv;
-    auto g = DebugManager::instance();
-    if (parser.isSet("gdb"))
-        g->setGdbCommand(parser.value("gdb"));
     if (parser.isSet("init"))
         gdbArgv.append({ "-x", parser.value("init") });
     if (parser.isSet("gdbcmd"))
         for (const auto& s: parser.values("gdbcmd"))
             gdbArgv.append({ "-ex", s });
+
+    if (batch) {
+        BatchRunner runner;
+        runner.setGdbCommand(parser.isSet("gdb")? parser.value("gdb") : QString{"gdb"});
+        runner.setGdbArgs(gdbArgv);
+        runner.setExecutable(parser.positionalArguments().value(0));
+        runner.setCores(parser.values("core") + parser.positionalArguments().mid(1));
+        runner.setExpressions(parser.values("expr"));
+        runner.setOutput(parser.value("output"));
+        runner.setJobs(parser.value("jobs").toInt());
+        runner.setTimeout(parser.value("timeout").toInt());
+        QObject::connect(&runner, &BatchRunner::finished, a.data(), &QCoreApplication::exit);
+        QTimer::singleShot(0, &runner, &BatchRunner::start);
+        return a->exec();
+    }
+
+    auto g = DebugManager::instance();
+    if (parser.isSet("gdb"))
+        g->setGdbCommand(parser.value("gdb"));
     for (const auto& cmd: parser.positionalArguments())
         gdbArgv.append(cmd);
     if (!gdbArgv.isEmpty())
@@ -44,5 +88,12 @@ int main(int argc, char *argv[])
 
     MainWidget w;
     w.show();
-    return a.exec();
+    // Scanning $PATH for gdb waits until the window is up
+    QTimer::singleShot(0, GdbLocator::instance(), &GdbLocator::start);
+    QTimer::singleShot(0, []() {
+        auto s = perf::Stats::instance();
+        if (s->isEnabled())
+            s->addTime("startup.firstEventLoop", 0, s->now());
+    });
+    return a->exec();
 }
@@ -1,10 +1,20 @@
 #include "mainwidget.h"
 #include "ui_mainwidget.h"
 
+#include "contextrefresher.h"
+#include "gdbpool.h"
+#include "hoverevaluator.h"
+#include "inlinevalues.h"
+#include "perfstats.h"
+#include "sharedcache.h"
+#include "sourceloader.h"
+
 #include "dialogabout.h"
+#include "dialogbreakpoint.h"
 #include "dialognewwatch.h"
 #include "dialogstartdebug.h"
 
+#include <Qsci/qscilexercpp.h>
 #include <Qsci/qsciscintilla.h>
 
 #include <QTextStream>
@@ -118,6 +128,7 @@ static QLabel *createMessageLabel(QWidget *w)
 static void configureEditor(QsciScintilla *ed)
 {
     ed->setReadOnly(true);
+    ed->setUtf8(true);
     ed->setCaretForegroundColor(conf::editor::CARET_FG);
     ed->setCaretLineVisible(true);
     ed->setCaretLineBackgroundColor(conf::editor::CARET_BG);
@@ -133,7 +144,14 @@ static void configureEditor(QsciScintilla *ed)
     ed->markerDefine(QsciScintilla::Background, QsciScintilla::SC_MARK_BACKGROUND);
     ed->setMarkerBackgroundColor(conf::editor::MARKER_LINE_BG, QsciScintilla::SC_MARK_BACKGROUND);
     ed->setAnnotationDisplay(QsciScintilla::AnnotationIndented);
-    ed->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    auto font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    ed->setFont(font);
+    auto lexer = new QsciLexerCPP{ed};
+    lexer->setFont(font);
+    ed->setLexer(lexer);
+    // Style the visible text first and the remainder of the document in idle
+    // time, so large files do not stall on the lexer
+    ed->SendScintilla(QsciScintilla::SCI_SETIDLESTYLING, QsciScintilla::SC_IDLESTYLING_ALL);
 }
 
 static void configureSplitters(Ui::MainWidget *ui)
@@ -192,22 +210,40 @@ static void createModels(Ui::MainWidget *ui)
 MainWidget::MainWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::MainWidget)
+    , m_refresher(new ContextRefresher(this))
+    , m_inlineValues(nullptr)
+    , m_hover(nullptr)
+    , m_loader(nullptr)
+    , m_msgLabel(nullptr)
 {
+    PERF_SCOPE("MainWidget::MainWidget");
     ui->setupUi(this);
     configureEditor(ui->textEdit);
     configureSplitters(ui);
     createModels(ui);
-
-    auto g = DebugManager::instance();
-
+    m_msgLabel = createMessageLabel(ui->textEdit);
+    m_inlineValues = new InlineValues(ui->textEdit, this);
+    m_hover = new HoverEvaluator(ui->textEdit, this);
+    m_loader = new SourceLoader(ui->textEdit, this);
+
+    connect(m_loader, &SourceLoader::ready, this, &MainWidget::sourceReady);
+    connect(m_loader, &SourceLoader::finished, this, &MainWidget::sourceFinished);
+    connect(m_loader, &SourceLoader::failed, [this](const QString& fullpath) {
+        qDebug() << "error opening file " << fullpath;
+        m_whenSourceReady = {};
+    });
     connect(ui->buttonAbout, &QToolButton::clicked, []() { DialogAbout().exec(); });
     connect(ui->buttonRun, &QToolButton::clicked, this, &MainWidget::toggleRunStop);
     connect(ui->buttonDebugStart, &QToolButton::clicked, this, &MainWidget::startDebuggin);
-    connect(ui->buttonQuit, &QToolButton::clicked, g, &DebugManager::quit);
-    connect(ui->buttonNext, &QToolButton::clicked, g, &DebugManager::commandNext);
-    connect(ui->buttonNextInto, &QToolButton::clicked, g, &DebugManager::commandStep);
-    connect(ui->buttonFinish, &QToolButton::clicked, g, &DebugManager::commandFinish);
+    connect(ui->buttonQuit, &QToolButton::clicked, [this]() { m_debug->quit(); });
+    connect(ui->buttonNext, &QToolButton::clicked, [this]() { m_debug->commandNext(); });
+    connect(ui->buttonNextInto, &QToolButton::clicked, [this]() { m_debug->commandStep(); });
+    connect(ui->buttonFinish, &QToolButton::clicked, [this]() { m_debug->commandFinish(); });
     connect(ui->buttonAppQuit, &QToolButton::clicked, this, &MainWidget::close);
+    connect(ui->buttonSessionNew, &QToolButton::clicked, this, &MainWidget::newSession);
+    connect(ui->buttonSessionClose, &QToolButton::clicked, this, &MainWidget::closeSession);
+    connect(ui->sessionSelector, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWidget::sessionSelected);
     connect(ui->commadLine, &QLineEdit::returnPressed, this, &MainWidget::executeGdbCommand);
     connect(ui->treeView, &QTreeView::activated, this, &MainWidget::fileViewActivate);
     connect(ui->stackTraceView, &QTableView::doubleClicked, this, &MainWidget::stackTraceClicked);
@@ -215,11 +251,88 @@ MainWidget::MainWidget(QWidget *parent)
     connect(ui->buttonWatchAdd, &QToolButton::clicked, this, &MainWidget::buttonAddWatchClicked);
     connect(ui->buttonWatchDel, &QToolButton::clicked, this, &MainWidget::buttonDelWatchClicked);
     connect(ui->buttonWatchClear, &QToolButton::clicked, this, &MainWidget::buttonClrWatchClicked);
+    connect(m_refresher, &ContextRefresher::refresh, this, &MainWidget::refreshContext);
+    connect(ui->symbolView, &SymbolView::locationActivated, this, &MainWidget::showLocation);
+    connect(ui->parallelStacksView, &ParallelStacksView::locationActivated, this, &MainWidget::showLocation);
+    connect(ui->profilerView, &ProfilerView::locationActivated, this, &MainWidget::showLocation);
+    connect(ui->profilerView, &ProfilerView::samplingChanged, this, &MainWidget::suspendTargetViews);
+    connect(ui->breakpointView, &BreakpointView::editRequested, this, &MainWidget::editBreakpoint);
+
+    // The first session keeps using the shared instance, so code that still
+    // reaches for DebugManager::instance() talks to the same gdb
+    m_sessions.append(DebugManager::instance());
+    ui->sessionSelector->addItem(tr("Session %1").arg(++m_sessionSerial));
+    setSession(DebugManager::instance());
+}
+
+MainWidget::~MainWidget()
+{
+    delete ui;
+}
+
+void MainWidget::closeEvent(QCloseEvent *e)
+{
+    if (sessionsExecuting()) {
+        auto r = QMessageBox::question(this, tr("Exit?"), tr("Programm is running. Exit anywere?"));
+        if (r == QMessageBox::Yes) {
+            for (auto g: m_sessions) {
+                if (!g->isGdbExecuting())
+                    continue;
+                connect(g, &DebugManager::gdbProcessTerminated, this, [this]() {
+                    if (!sessionsExecuting())
+                        close();
+                });
+                g->quit();
+            }
+        }
+        e->ignore();
+    } else {
+        GdbPool::instance()->clear();
+        e->accept();
+    }
+}
 
-    auto msgLabel = createMessageLabel(ui->textEdit);
+bool MainWidget::sessionsExecuting() const
+{
+    for (auto g: m_sessions)
+        if (g->isGdbExecuting())
+            return true;
+    return false;
+}
 
-    connect(g, &DebugManager::gdbError, msgLabel, &QLabel::setText);
-    connect(g, &DebugManager::gdbError, msgLabel, &QLabel::show);
+void MainWidget::setSession(DebugManager *g)
+{
+    if (g == m_debug)
+        return;
+    if (m_debug) {
+        disconnect(m_debug, nullptr, this, nullptr);
+        disconnect(m_debug, nullptr, m_msgLabel, nullptr);
+        disconnect(m_debug, nullptr, ui->gdbOut, nullptr);
+        disconnect(m_debug, nullptr, m_refresher, nullptr);
+    }
+    m_refresher->cancel();
+    m_msgLabel->hide();
+    // Stop generations are counted per session
+    m_frameCache.clear();
+    m_frameFetch = -1;
+    m_currentThread = 0;
+    m_debug = g;
+
+    ui->memoryView->setDebugManager(g);
+    ui->disassemblyView->setDebugManager(g);
+    ui->registerView->setDebugManager(g);
+    ui->samplerView->setDebugManager(g);
+    ui->schedulerView->setDebugManager(g);
+    ui->libraryView->setDebugManager(g);
+    ui->symbolView->setDebugManager(g);
+    ui->parallelStacksView->setDebugManager(g);
+    ui->profilerView->setDebugManager(g);
+    ui->breakpointView->setDebugManager(g);
+    m_inlineValues->setDebugManager(g);
+    m_hover->setDebugManager(g);
+
+    connect(g, &DebugManager::gdbError, m_msgLabel, &QLabel::setText);
+    connect(g, &DebugManager::gdbError, m_msgLabel, &QLabel::show);
     connect(g, &DebugManager::streamDebugInternal, ui->gdbOut, &QTextBrowser::append);
     connect(g, &DebugManager::updateThreads, this, &MainWidget::debugUpdateThreads);
     connect(g, &DebugManager::updateCurrentFrame, this, &MainWidget::debugUpdateCurrentFrame);
@@ -227,6 +340,7 @@ MainWidget::MainWidget(QWidget *parent)
     connect(g, &DebugManager::updateStackFrame, this, &MainWidget::debugUpdateStackFrame);
     connect(g, &DebugManager::asyncRunning, this, &MainWidget::debugAsyncRunning);
     connect(g, &DebugManager::asyncStopped, this, &MainWidget::debugAsyncStopped);
+    connect(g, &DebugManager::terminated, m_refresher, &ContextRefresher::cancel);
     connect(g, &DebugManager::started, this, &MainWidget::updateSourceFiles);
     connect(g, &DebugManager::started, this, &MainWidget::enableGuiItems);
     connect(g, &DebugManager::terminated, this, &MainWidget::disableGuiItems);
@@ -236,31 +350,64 @@ MainWidget::MainWidget(QWidget *parent)
     connect(g, &DebugManager::variableDeleted, this, &MainWidget::debugVariableRemoved);
     connect(g, &DebugManager::variablesChanged, this, &MainWidget::debugVariablesUpdate);
 
+    // Views only hold what the previous session showed, rebuild them from g
     disableGuiItems();
+    if (g->isGdbExecuting()) {
+        enableGuiItems();
+        updateSourceFiles();
+        for (const auto& var: g->vatchVars())
+            debugVariableCreated(var);
+        // A pre-warmed gdb has no inferior to show yet
+        if (g->isInferiorRunning())
+            debugAsyncRunning();
+        else if (g->stopGeneration() > 0)
+            refreshContext();
+    }
+    ui->buttonSessionClose->setEnabled(m_sessions.indexOf(g) > 0);
 }
 
-MainWidget::~MainWidget()
+void MainWidget::updateSessionName(DebugManager *g, const QString &name)
 {
-    delete ui;
+    int index = m_sessions.indexOf(g);
+    if (index != -1)
+        ui->sessionSelector->setItemText(index, name);
 }
 
-void MainWidget::closeEvent(QCloseEvent *e)
+void MainWidget::newSession()
 {
-    auto g = DebugManager::instance();
+    auto g = new DebugManager(this);
+    m_sessions.append(g);
+    ui->sessionSelector->addItem(tr("Session %1").arg(++m_sessionSerial));
+    ui->sessionSelector->setCurrentIndex(m_sessions.size() - 1);
+}
+
+void MainWidget::closeSession()
+{
+    int index = m_sessions.indexOf(m_debug);
+    // The first session holds the shared instance (or the gdb that replaced
+    // it) and stays
+    if (index < 1)
+        return;
+    auto g = m_sessions.takeAt(index);
+    // Switches to a neighbour through sessionSelected before g goes away
+    ui->sessionSelector->removeItem(index);
     if (g->isGdbExecuting()) {
-        auto r = QMessageBox::question(this, tr("Exit?"), tr("Programm is running. Exit anywere?"));
-        if (r == QMessageBox::Yes) {
-            connect(g, &DebugManager::gdbProcessTerminated, this, &MainWidget::close);
-            g->quit();
-        }
-        e->ignore();
-    } else
-        e->accept();
+        connect(g, &DebugManager::gdbProcessTerminated, g, &QObject::deleteLater);
+        g->quit();
+    } else {
+        g->deleteLater();
+    }
 }
 
 void MainWidget::executeGdbCommand()
 {
-    DebugManager::instance()->command(ui->commadLine->text());
+    m_debug->userCommand(ui->commadLine->text());
+}
+
+void MainWidget::sessionSelected(int index)
+{
+    if (index >= 0 && index < m_sessions.size())
+        setSession(m_sessions.at(index));
 }
 
 void MainWidget::ensureTreeViewVisible(const QString &fullpath)
@@ -281,11 +428,14 @@ void MainWidget::setItemsEnable(bool en)
     ui->buttonDebugStart->setEnabled(!en);
     if (!en) {
         ui->threadSelector->clear();
-        ui->textEdit->clear();
+        m_loader->clear();
         stdModel(ui->contextFrameView)->removeAllRows();
         stdModel(ui->contextFrameView)->removeAllRows();
         stdModel(ui->stackTraceView)->removeAllRows();
         stdModel(ui->watchView)->removeAllRows();
+        ui->memoryView->clear();
+        ui->disassemblyView->clear();
+        ui->registerView->clear();
         if (ui->treeView->model())
             ui->treeView->model()->deleteLater();
         ui->gdbOut->clear();
@@ -294,8 +444,27 @@ void MainWidget::setItemsEnable(bool en)
 
 void MainWidget::updateSourceFiles()
 {
-    DebugManager::instance()->commandAndResponse(
-        "-file-list-exec-source-files", [this](const QVariant& res) {
+    auto g = m_debug;
+    // Sessions on the same executable share its source list, asking gdb for
+    // it is slow on large programs
+    g->enqueue("-list-thread-groups", DebugManager::Priority_t::Refresh, [this, g](const QVariant& res) {
+        if (g != m_debug)
+            return;
+        QString executable;
+        for (const auto& e: res.toMap().value("groups").toList()) {
+            executable = e.toMap().value("executable").toString();
+            if (!executable.isEmpty())
+                break;
+        }
+        auto cached = SharedCache::instance()->metadata("sources", executable).toStringList();
+        if (!executable.isEmpty())
+            updateSessionName(g, QFileInfo{executable}.fileName());
+        if (!cached.isEmpty()) {
+            setSourceFiles(cached);
+            return;
+        }
+        g->enqueue("-file-list-exec-source-files", DebugManager::Priority_t::Refresh,
+                   [this, g, executable](const QVariant& res) {
             auto fileListData = res.toMap().value("files").toList();
             QSet<QString> files;
             for (const auto& e: fileListData) {
@@ -306,38 +475,82 @@ void MainWidget::updateSourceFiles()
                 }
             }
             auto fileList = files.toList();
-            auto commonRoot = find_root(fileList);
-            new FileSystemModel(commonRoot, ui->treeView);
-            DebugManager::instance()->command("-stack-info-frame");
+            if (!executable.isEmpty())
+                SharedCache::instance()->setMetadata("sources", executable, fileList);
+            if (g == m_debug)
+                setSourceFiles(fileList);
+        });
     });
 }
 
+void MainWidget::setSourceFiles(const QStringList &files)
+{
+    auto commonRoot = find_root(files);
+    new FileSystemModel(commonRoot, ui->treeView);
+    m_debug->command("-stack-info-frame");
+}
+
 static int digitsIn(int v) { return 1 + int(::floor(::log10(v))); }
 
-bool MainWidget::openFile(const QString &fullpath)
+void MainWidget::openFile(const QString &fullpath, int line, const std::function<void()>& then)
 {
-    QFile f{fullpath};
-    if (!f.open(QFile::ReadOnly)) {
-        qDebug() << "error opening file " << fullpath << f.errorString();
-        return false;
+    bool reopen = fullpath == ui->textEdit->windowFilePath();
+    m_whenSourceReady = then;
+    if (!m_loader->open(fullpath, line))
+        return;
+    if (reopen) {
+        ensureTreeViewVisible(fullpath);
+        auto f = m_whenSourceReady;
+        m_whenSourceReady = {};
+        if (f)
+            f();
+        return;
     }
-    ui->textEdit->read(&f);
-    int n = digitsIn(ui->textEdit->lines()) + 1;
+    sourceReady(fullpath);
+    if (!m_loader->isLoading())
+        sourceFinished(fullpath);
+}
+
+void MainWidget::sourceReady(const QString &fullpath)
+{
+    PERF_SCOPE("MainWidget::sourceReady");
+    int n = digitsIn(m_loader->lineCount()) + 1;
     int w = QFontMetrics(ui->textEdit->font()).width("0") * n;
     ui->textEdit->setMarginWidth(0, w);
-    ui->textEdit->setWindowFilePath(fullpath);
-    ui->textEdit->markerDeleteAll(QsciScintilla::SC_MARK_BACKGROUND);
+    updateBreakpointMarkers();
+    ensureTreeViewVisible(fullpath);
+    auto f = m_whenSourceReady;
+    m_whenSourceReady = {};
+    if (f)
+        f();
+}
+
+void MainWidget::sourceFinished(const QString &)
+{
+    // Breakpoints below the part inserted first had no line to go to
+    updateBreakpointMarkers();
+}
+
+void MainWidget::updateBreakpointMarkers()
+{
     ui->textEdit->markerDeleteAll(QsciScintilla::SC_MARK_CIRCLE);
-    auto bpList = DebugManager::instance()->breakpointsForFile(fullpath);
+    auto bpList = m_debug->breakpointsForFile(ui->textEdit->windowFilePath());
     for (const auto& bp: bpList)
         ui->textEdit->markerAdd(bp.line - 1, QsciScintilla::SC_MARK_CIRCLE);
-    ensureTreeViewVisible(fullpath);
-    return true;
+}
+
+void MainWidget::showLocation(const QString &fullpath, int line)
+{
+    openFile(fullpath, line, [this, line]() {
+        ui->textEdit->setCursorPosition(line - 1, 0);
+        ui->textEdit->ensureLineVisible(line - 1);
+        ui->textEdit->setFocus();
+    });
 }
 
 void MainWidget::toggleBreakpointAt(const QString &file, int line)
 {
-    auto g = DebugManager::instance();
+    auto g = m_debug;
     auto bp = g->breakpointByFileLine(file, line);
     if (!bp.isValid()) {
         auto bpText = QString{"%1:%2"}.arg(file).arg(line);
@@ -350,7 +563,7 @@ void MainWidget::toggleBreakpointAt(const QString &file, int line)
 void MainWidget::buttonAddWatchClicked() {
     DialogNewWatch d(ui->textEdit->selectedText(), this);
     if (d.exec())
-        DebugManager::instance()->traceAddVariable(d.watchExpr(), d.watchName());
+        m_debug->traceAddVariable(d.watchExpr(), d.watchName());
 }
 
 void MainWidget::buttonDelWatchClicked()
@@ -359,13 +572,13 @@ void MainWidget::buttonDelWatchClicked()
     for (const auto i: ui->watchView->selectionModel()->selectedRows(0)) {
         auto item = watchModel->itemFromIndex(i);
         if (item)
-            DebugManager::instance()->traceDelVariable(item->text());
+            m_debug->traceDelVariable(item->text());
     }
 }
 
 void MainWidget::buttonClrWatchClicked() {
     auto watchModel = stdModel(ui->watchView);
-    auto g = DebugManager::instance();
+    auto g = m_debug;
     for (int row=0; row<watchModel->rowCount(); row++) {
         auto item = watchModel->item(row, 0);
         if (item)
@@ -373,11 +586,49 @@ void MainWidget::buttonClrWatchClicked() {
     }
 }
 
-void MainWidget::editorMarginClicked(int margin, int line, Qt::KeyboardModifiers) {
-    if (margin == 1)
+void MainWidget::editorMarginClicked(int margin, int line, Qt::KeyboardModifiers modifiers) {
+    if (margin != 1)
+        return;
+    // Shift+click edits an existing breakpoint instead of removing it
+    auto bp = m_debug->breakpointByFileLine(ui->textEdit->windowFilePath(), line+1);
+    if (bp.isValid() && modifiers.testFlag(Qt::ShiftModifier))
+        editBreakpoint(bp.number);
+    else
         toggleBreakpointAt(ui->textEdit->windowFilePath(), line+1);
 }
 
+void MainWidget::editBreakpoint(int bpid)
+{
+    auto g = m_debug;
+    if (!g->breakpointById(bpid).isValid())
+        return;
+    g->queryTargetConditions([this, g, bpid](bool targetConditions) {
+        // Not from inside gdb's reply: the modal loop would read more output
+        QTimer::singleShot(0, this, [this, g, bpid, targetConditions]() {
+            if (g == m_debug)
+                showBreakpointDialog(bpid, targetConditions);
+        });
+    });
+}
+
+void MainWidget::showBreakpointDialog(int bpid, bool targetConditions)
+{
+    auto g = m_debug;
+    auto bp = g->breakpointById(bpid);
+    if (!bp.isValid())
+        return;
+    DialogBreakpoint d{bp, g->resumePause(bpid), g->isRemote(), targetConditions, this};
+    if (d.exec() != QDialog::Accepted)
+        return;
+    // Set first, so a condition sent next is compiled to agent bytecode
+    if (!d.conditionEvaluation().isEmpty())
+        g->setConditionEvaluation(d.conditionEvaluation());
+    if (d.condition() != bp.condition)
+        g->breakCondition(bpid, d.condition());
+    if (d.ignoreCount() != bp.ignoreCount)
+        g->breakAfter(bpid, d.ignoreCount());
+}
+
 void MainWidget::fileViewActivate(const QModelIndex &idx) {
     auto model = qobject_cast<QFileSystemModel*>(ui->treeView->model());
     if (model) {
@@ -392,33 +643,93 @@ void MainWidget::stackTraceClicked(const QModelIndex &idx) {
     if (m) {
         auto item = m->item(idx.row(), 0);
         if (item) {
-            auto frame = item->data().value<gdb::Frame>();
-            DebugManager::instance()->commandAndResponse(
-                        QString{"-stack-select-frame %1"}.arg(frame.level),
-                        [this](const QVariant&) { triggerUpdateContext(); });
+            selectFrame(item->data().value<gdb::Frame>());
         } else
             qDebug() << "not item for model" << idx;
     } else
         qDebug() << "not model for stack trace view";
 }
 
+static QList<gdb::Variable> parseLocals(const QVariant& r)
+{
+    QList<gdb::Variable> locals;
+    for (const auto& e: r.toMap().value("variables").toList())
+        locals.append(gdb::Variable::parseMap(e.toMap()));
+    return locals;
+}
+
+void MainWidget::selectFrame(const gdb::Frame &frame)
+{
+    PERF_SCOPE("MainWidget::selectFrame");
+    auto g = m_debug;
+    int generation = g->stopGeneration();
+    int thread = m_currentThread;
+    // The stack list already carries the source position, only locals may be missing
+    m_frameCache.setFrame(generation, thread, frame);
+    debugUpdateCurrentFrame(frame);
+    // The command line, new watches and varobj updates evaluate in gdb's
+    // selected frame; its ^done carries no frame, so nothing is broadcast
+    g->command(QString{"-stack-select-frame %1"}.arg(frame.level));
+    ui->registerView->frameSelected(thread, frame.level);
+    // A reply for a frame the user already left must not overwrite this one
+    if (m_frameFetch != -1)
+        g->cancel(m_frameFetch);
+    m_frameFetch = -1;
+    auto cached = m_frameCache.find(generation, thread, frame.level);
+    if (cached && cached->hasLocals) {
+        debugUpdateLocalVariables(cached->locals);
+        return;
+    }
+    // Explicit --thread/--frame keep the reply tied to this frame even if the
+    // selection moves on meanwhile; it is shown through updateLocalVariables
+    auto cmd = QString{"-stack-list-variables %1--frame %2 --simple-values"}
+            .arg(thread > 0? QString{"--thread %1 "}.arg(thread) : QString{}).arg(frame.level);
+    m_frameFetch = g->contextCommand(cmd, [this, generation, thread, frame](const QVariant& r) {
+        m_frameFetch = -1;
+        m_frameCache.setLocals(generation, thread, frame.level, parseLocals(r));
+    });
+}
+
 void MainWidget::startDebuggin()
 {
     DialogStartDebug d{this};
     if (d.exec() == QDialog::Accepted) {
-        auto g = DebugManager::instance();
-        QStringList argv;
+        auto g = m_debug;
+        auto pool = GdbPool::instance();
+        auto warm = pool->take(d.gdbExecutable(), d.executableFile());
+        if (warm) {
+            // The warm gdb takes over this session's slot in the selector
+            warm->setParent(this);
+            m_sessions[m_sessions.indexOf(g)] = warm;
+            setSession(warm);
+            if (g != DebugManager::instance())
+                g->deleteLater();
+            g = warm;
+        } else if (d.prewarm()) {
+            pool->prepare(d.gdbExecutable(), d.executableFile());
+        }
+        QString initScript = d.initScriptName();
         if (d.needWriteInitScript()) {
+            initScript.clear();
             auto gdbinit = new QTemporaryFile{QDir{QDir::tempPath()}.filePath(".gdbinit-XXXXXX"), this};
             connect(g, &DebugManager::terminated, [gdbinit]() { gdbinit->remove(); });
             if (gdbinit->open()) {
                 gdbinit->write(d.initScript().toLocal8Bit());
                 gdbinit->close();
-                argv.append({ "-x", gdbinit->fileName() });
+                initScript = gdbinit->fileName();
             }
-        } else {
-            argv.append({ "-x", d.initScriptName() });
         }
+        updateSessionName(g, QFileInfo{d.executableFile()}.fileName());
+        if (warm) {
+            // Symbols are loaded already, only the connect/run part is left
+            if (!initScript.isEmpty())
+                g->userCommand(QString{"-interpreter-exec console \"source %1\""}
+                           .arg(QString{initScript}.replace('\\', "\\\\").replace('"', "\\\"")));
+            return;
+        }
+        QStringList argv;
+        if (!initScript.isEmpty())
+            argv.append({ "-x", initScript });
         argv.append(d.executableFile());
         g->setGdbArgs(argv);
         g->setGdbCommand(d.gdbExecutable());
@@ -428,16 +739,34 @@ void MainWidget::startDebuggin()
 
 void MainWidget::triggerUpdateContext()
 {
-    auto g = DebugManager::instance();
-    g->command("-stack-info-frame");
-    g->command("-thread-info");
-    g->command("-stack-list-frames");
-    g->command("-stack-list-variables --simple-values");
+    auto g = m_debug;
+    // Threads first, the frame and locals below are keyed by the current thread
+    g->contextCommand("-thread-info");
+    g->contextCommand("-stack-info-frame");
+    g->contextCommand("-stack-list-frames");
+    // gdb's selected frame stays at the innermost one, the stack view uses --frame
+    m_frameFetch = -1;
+    g->contextCommand("-stack-list-variables --simple-values", [this, g](const QVariant& r) {
+        m_frameCache.setLocals(g->stopGeneration(), m_currentThread, 0, parseLocals(r));
+    });
+}
+
+void MainWidget::refreshContext()
+{
+    PERF_SCOPE("MainWidget::refreshContext");
+    auto g = m_debug;
+    // Resumed again before the delay expired, the next stop will reschedule
+    if (!g->isGdbExecuting() || g->isInferiorRunning())
+        return;
+    triggerUpdateContext();
+    // Varobj change lists are incremental and must never be dropped, so the
+    // update is issued here once per refresh instead of being cancellable
+    g->traceUpdateAll();
 }
 
 void MainWidget::toggleRunStop()
 {
-    auto g = DebugManager::instance();
+    auto g = m_debug;
     if (g->isInferiorRunning())
         g->commandInterrupt();
     else
@@ -445,6 +774,7 @@ void MainWidget::toggleRunStop()
 }
 
 void MainWidget::debugUpdateLocalVariables(const QList<gdb::Variable> &locals) {
+    PERF_SCOPE("MainWidget::debugUpdateLocalVariables");
     auto model = stdModel(ui->contextFrameView);
     model->removeAllRows();
     for (const auto& e: locals) {
@@ -455,23 +785,27 @@ void MainWidget::debugUpdateLocalVariables(const QList<gdb::Variable> &locals) {
                          });
     }
     ui->contextFrameView->resizeColumnToContents(0);
+    m_inlineValues->setLocals(locals);
 }
 
 void MainWidget::debugUpdateCurrentFrame(const gdb::Frame &frame) {
-    if (frame.fullpath != ui->textEdit->windowFilePath()) {
-        if (!openFile(frame.fullpath))
-            return;
-    } else {
-        ensureTreeViewVisible(frame.fullpath);
-    }
-    int line = frame.line - 1;
+    PERF_SCOPE("MainWidget::debugUpdateCurrentFrame");
+    m_hover->setFrame(m_currentThread, frame.level, frame.addr);
+    m_inlineValues->setFrame(m_currentThread, frame.level);
     ui->textEdit->markerDeleteAll(QsciScintilla::SC_MARK_BACKGROUND);
-    ui->textEdit->markerAdd(line, QsciScintilla::SC_MARK_BACKGROUND);
-    ui->textEdit->ensureLineVisible(line);
+    openFile(frame.fullpath, frame.line, [this, frame]() {
+        int line = frame.line - 1;
+        ui->textEdit->markerDeleteAll(QsciScintilla::SC_MARK_BACKGROUND);
+        ui->textEdit->markerAdd(line, QsciScintilla::SC_MARK_BACKGROUND);
+        ui->textEdit->ensureLineVisible(line);
+        m_inlineValues->setCurrentLine(frame.fullpath, frame.line);
+    });
 }
 
 void MainWidget::debugUpdateThreads(int curr, const QList<gdb::Thread> &threads)
 {
+    PERF_SCOPE("MainWidget::debugUpdateThreads");
+    m_currentThread = curr;
     ui->threadSelector->clear();
     int currIdx = -1;
     for (const auto& e: threads) {
@@ -485,6 +819,7 @@ void MainWidget::debugUpdateThreads(int curr, const QList<gdb::Thread> &threads)
 
 void MainWidget::debugUpdateStackFrame(const QList<gdb::Frame> &stackTrace)
 {
+    PERF_SCOPE("MainWidget::debugUpdateStackFrame");
     auto model = stdModel(ui->stackTraceView);
     model->removeAllRows();
     for (const auto& frame: stackTrace) {
@@ -504,15 +839,30 @@ void MainWidget::debugUpdateStackFrame(const QList<gdb::Frame> &stackTrace)
 
 void MainWidget::debugAsyncStopped(const gdb::AsyncContext& ctx)
 {
+    PERF_SCOPE("MainWidget::debugAsyncStopped");
+    // Sampling stops are continued right away, there is nothing to show
+    if (ui->profilerView->isSampling())
+        return;
     if (ctx.reason == gdb::AsyncContext::Reason::exitedNormally) {
-        DebugManager::instance()->quit();
+        m_debug->quit();
     } else {
         ui->buttonRun->setIcon(QIcon{":/images/debug-run-v2.svg"});
-        triggerUpdateContext();
-        DebugManager::instance()->traceUpdateAll();
+        m_refresher->schedule();
     }
 }
 
+void MainWidget::suspendTargetViews(bool suspend)
+{
+    // Their reads on every sampling stop would lengthen the pause being sampled
+    auto g = suspend? nullptr : m_debug;
+    ui->memoryView->setDebugManager(g);
+    ui->disassemblyView->setDebugManager(g);
+    ui->registerView->setDebugManager(g);
+    // Sampling may end on a stop these views did not see
+    if (g && g->isGdbExecuting() && !g->isInferiorRunning())
+        ui->registerView->targetStopped();
+}
+
 void MainWidget::debugAsyncRunning()
 {
     ui->buttonRun->setIcon(QIcon{":/images/debug-pause-v2.svg"});
@@ -550,12 +900,13 @@ void MainWidget::debugVariableRemoved(const gdb::Variable &var) {
 }
 
 void MainWidget::debugVariablesUpdate(const QStringList &changes) {
+    PERF_SCOPE("MainWidget::debugVariablesUpdate");
     auto watchModel = stdModel(ui->watchView);
     QList<int> rowsChanged;
     for (const auto& e: changes)
         for (const auto& k: watchModel->findItems(e))
             rowsChanged += k->row();
-    auto g = DebugManager::instance();
+    auto g = m_debug;
     for (const auto& row: rowsChanged) {
         auto name = watchModel->item(row, 0)->text();
         auto item = watchModel->item(row, 1);
@@ -3,12 +3,21 @@
 
 #include <QWidget>
 
+#include <functional>
+
 #include "debugmanager.h"
+#include "framecache.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWidget; }
 QT_END_NAMESPACE
 
+class ContextRefresher;
+class HoverEvaluator;
+class InlineValues;
+class QLabel;
+class SourceLoader;
+
 class MainWidget : public QWidget
 {
     Q_OBJECT
@@ -18,6 +27,28 @@ public:
     ~MainWidget();
 private:
     Ui::MainWidget *ui;
+    ContextRefresher *m_refresher;
+    InlineValues *m_inlineValues;
+    HoverEvaluator *m_hover;
+    SourceLoader *m_loader;
+    std::function<void()> m_whenSourceReady;
+    QLabel *m_msgLabel;
+    DebugManager *m_debug = nullptr;
+    QList<DebugManager*> m_sessions;
+    int m_sessionSerial = 0;
+    FrameCache m_frameCache;
+    int m_currentThread = 0;
+    int m_frameFetch = -1;
+
+    bool sessionsExecuting() const;
+    void setSession(DebugManager *g);
+    void updateSessionName(DebugManager *g, const QString& name);
+    void setSourceFiles(const QStringList& files);
+    void selectFrame(const gdb::Frame& frame);
+    // Loads in the background, then runs then once line is in the editor
+    void openFile(const QString& fullpath, int line = 1, const std::function<void()>& then = {});
+    void updateBreakpointMarkers();
+    void showBreakpointDialog(int bpid, bool targetConditions);
 
 protected:
     virtual void closeEvent(QCloseEvent *e);
@@ -29,8 +60,11 @@ private slots:
     void enableGuiItems() { setItemsEnable(true); }
     void disableGuiItems() { setItemsEnable(false); }
     void updateSourceFiles();
-    bool openFile(const QString& fullpath);
+    void sourceReady(const QString& fullpath);
+    void sourceFinished(const QString& fullpath);
+    void showLocation(const QString& fullpath, int line);
     void toggleBreakpointAt(const QString& file, int line);
+    void editBreakpoint(int bpid);
 
     void buttonAddWatchClicked();
     void buttonDelWatchClicked();
@@ -41,7 +75,11 @@ private slots:
     void stackTraceClicked(const QModelIndex& idx);
 
     void startDebuggin();
+    void newSession();
+    void closeSession();
+    void sessionSelected(int index);
     void triggerUpdateContext();
+    void refreshContext();
     void toggleRunStop();
 
     void debugUpdateLocalVariables(const QList<gdb::Variable>& locals);
@@ -50,6 +88,7 @@ private slots:
     void debugUpdateStackFrame(const QList<gdb::Frame>& stackTrace);
     void debugAsyncStopped(const gdb::AsyncContext &ctx);
     void debugAsyncRunning();
+    void suspendTargetViews(bool suspend);
 
     void debugBreakInserted(const gdb::Breakpoint& bp);
     void debugBreakRemoved(const gdb::Breakpoint& bp);
@@ -0,0 +1,194 @@
+#include "memorycache.h"
+#include "debugmanager.h"
+
+#include <QVariant>
+
+constexpr quint64 MemoryCache::PAGE_SIZE;
+constexpr int MemoryCache::MAX_PAGES_PER_REQUEST;
+
+MemoryCache::MemoryCache(QObject *parent) : QObject(parent)
+{
+}
+
+void MemoryCache::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    invalidate();
+    if (g) {
+        connect(g, &DebugManager::asyncStopped, this, &MemoryCache::invalidate);
+        connect(g, &DebugManager::memoryChanged, this, &MemoryCache::invalidateRange);
+        connect(g, &DebugManager::terminated, this, &MemoryCache::invalidate);
+    }
+}
+
+const MemoryCache::Page *MemoryCache::page(quint64 page) const
+{
+    auto it = m_pages.constFind(page);
+    return it == m_pages.cend()? nullptr : &it.value();
+}
+
+bool MemoryCache::read(quint64 addr, int len, QByteArray *out, QBitArray *valid) const
+{
+    out->fill('\0', len);
+    valid->fill(false, len);
+    bool complete = true;
+    int done = 0;
+    while (done < len) {
+        auto a = addr + quint64(done);
+        auto p = page(pageOf(a));
+        int offset = int(a % PAGE_SIZE);
+        int n = qMin(len - done, int(PAGE_SIZE) - offset);
+        if (p) {
+            for (int i = 0; i < n; i++) {
+                (*out)[done + i] = p->data.at(offset + i);
+                valid->setBit(done + i, p->valid.testBit(offset + i));
+            }
+        } else {
+            complete = false;
+        }
+        done += n;
+    }
+    return complete;
+}
+
+void MemoryCache::fetch(quint64 addr, quint64 len)
+{
+    fetchRange(addr, len, DebugManager::Priority_t::Refresh);
+}
+
+void MemoryCache::prefetch(quint64 addr, quint64 len)
+{
+    fetchRange(addr, len, DebugManager::Priority_t::Background);
+}
+
+void MemoryCache::fetchRange(quint64 addr, quint64 len, DebugManager::Priority_t priority)
+{
+    // Only a non-stop session reads memory while the inferior runs
+    if (!m_debug || !m_debug->isGdbExecuting() || len == 0 ||
+        (m_debug->isInferiorRunning() && !m_debug->isNonStop()))
+        return;
+    auto first = pageOf(addr);
+    auto last = pageOf(addr + len - 1);
+    // Coalesce runs of missing pages into a single -data-read-memory-bytes
+    quint64 runStart = 0;
+    int runLen = 0;
+    for (auto p = first; p <= last; p++) {
+        bool missing = !m_pages.contains(p) && !m_pending.contains(p);
+        if (missing) {
+            if (runLen == 0)
+                runStart = p;
+            runLen++;
+        }
+        if ((!missing || runLen == MAX_PAGES_PER_REQUEST || p == last) && runLen > 0) {
+            request(runStart, runLen, priority);
+            runLen = 0;
+        }
+        if (p == last)
+            break;
+    }
+}
+
+void MemoryCache::invalidate()
+{
+    m_pages.clear();
+    m_pending.clear();
+    m_generation++;
+    emit invalidated();
+}
+
+void MemoryCache::invalidateRange(quint64 addr, quint64 len)
+{
+    if (len == 0)
+        return;
+    auto first = pageOf(addr);
+    auto last = pageOf(addr + len - 1);
+    for (auto p = first; p <= last; p++) {
+        m_pages.remove(p);
+        // A read in flight may predate the change
+        m_pending.remove(p);
+        if (p == last)
+            break;
+    }
+    emit updated(first * PAGE_SIZE, (last - first + 1) * PAGE_SIZE);
+}
+
+void MemoryCache::request(quint64 firstPage, int pageCount, DebugManager::Priority_t priority)
+{
+    int id = ++m_requestCounter;
+    for (int i = 0; i < pageCount; i++)
+        m_pending.insert(firstPage + quint64(i), id);
+    int generation = m_generation;
+    auto cmd = QString{"-data-read-memory-bytes 0x%1 %2"}
+            .arg(firstPage * PAGE_SIZE, 0, 16)
+            .arg(quint64(pageCount) * PAGE_SIZE);
+    m_debug->enqueue(cmd, priority, [this, generation, firstPage, pageCount, id](const QVariant& r) {
+        if (generation == m_generation)
+            store(firstPage, pageCount, id, r.toMap().value("memory").toList());
+    }, [this, generation, firstPage, pageCount, id](const QVariant& r) {
+        if (generation != m_generation)
+            return;
+        // A dropped prefetch is asked again by the next fetch of the range
+        if (DebugManager::isCancelled(r)) {
+            for (int i = 0; i < pageCount; i++) {
+                auto it = m_pending.find(firstPage + quint64(i));
+                if (it != m_pending.end() && it.value() == id)
+                    m_pending.erase(it);
+            }
+            return;
+        }
+        // Unreadable region: keep it cached as invalid bytes to avoid re-asking
+        store(firstPage, pageCount, id, {});
+    });
+}
+
+static int hexNibble(QChar c)
+{
+    auto u = c.unicode();
+    if (u >= '0' && u <= '9')
+        return u - '0';
+    if (u >= 'a' && u <= 'f')
+        return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F')
+        return u - 'A' + 10;
+    return -1;
+}
+
+void MemoryCache::store(quint64 firstPage, int pageCount, int request, const QVariantList &memory)
+{
+    // Pages changed or asked again since this request keep their newer state
+    QBitArray owned(pageCount);
+    for (int i = 0; i < pageCount; i++) {
+        auto it = m_pending.find(firstPage + quint64(i));
+        if (it == m_pending.end() || it.value() != request)
+            continue;
+        m_pending.erase(it);
+        owned.setBit(i);
+        auto& p = m_pages[firstPage + quint64(i)];
+        p.data.fill('\0', int(PAGE_SIZE));
+        p.valid.fill(false, int(PAGE_SIZE));
+    }
+    auto base = firstPage * PAGE_SIZE;
+    auto limit = base + quint64(pageCount) * PAGE_SIZE;
+    for (const auto& e: memory) {
+        auto m = e.toMap();
+        // begin is absolute, offset is only relative to the requested address
+        auto begin = m.value("begin").toString().toULongLong(nullptr, 16);
+        auto contents = m.value("contents").toString();
+        for (int i = 0; i + 1 < contents.size(); i += 2) {
+            auto a = begin + quint64(i / 2);
+            if (a < base || a >= limit || !owned.testBit(int(pageOf(a) - firstPage)))
+                continue;
+            int hi = hexNibble(contents.at(i));
+            int lo = hexNibble(contents.at(i + 1));
+            if (hi < 0 || lo < 0)
+                break;
+            auto& p = m_pages[pageOf(a)];
+            int offset = int(a % PAGE_SIZE);
+            p.data[offset] = char((hi << 4) | lo);
+            p.valid.setBit(offset);
+        }
+    }
+    emit updated(base, quint64(pageCount) * PAGE_SIZE);
+}
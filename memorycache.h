@@ -0,0 +1,61 @@
+#ifndef MEMORYCACHE_H
+#define MEMORYCACHE_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QObject>
+
+#include "debugmanager.h"
+
+class MemoryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint64 PAGE_SIZE = 1024;
+    static constexpr int MAX_PAGES_PER_REQUEST = 16;
+
+    struct Page {
+        QByteArray data;
+        QBitArray valid;
+    };
+
+    explicit MemoryCache(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+    static quint64 pageOf(quint64 addr) { return addr / PAGE_SIZE; }
+
+    bool isCached(quint64 page) const { return m_pages.contains(page); }
+    const Page *page(quint64 page) const;
+
+    // Copy [addr, addr + len) into out; valid has a bit set for every byte read
+    // from the target. Returns false if some page is not cached yet.
+    bool read(quint64 addr, int len, QByteArray *out, QBitArray *valid) const;
+
+public slots:
+    void fetch(quint64 addr, quint64 len);
+    // Same as fetch, but yields to everything else and may be dropped
+    void prefetch(quint64 addr, quint64 len);
+    void invalidate();
+    void invalidateRange(quint64 addr, quint64 len);
+
+signals:
+    void updated(quint64 addr, quint64 len);
+    void invalidated();
+
+private:
+    void fetchRange(quint64 addr, quint64 len, DebugManager::Priority_t priority);
+    void request(quint64 firstPage, int pageCount, DebugManager::Priority_t priority);
+    void store(quint64 firstPage, int pageCount, int request, const QVariantList& memory);
+
+    DebugManager *m_debug = nullptr;
+    QHash<quint64, Page> m_pages;
+    // page -> request it waits for; a page invalidated meanwhile loses its
+    // entry, so the stale reply is not stored
+    QHash<quint64, int> m_pending;
+    int m_generation = 0;
+    int m_requestCounter = 0;
+};
+
+#endif // MEMORYCACHE_H
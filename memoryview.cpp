@@ -0,0 +1,229 @@
+#include "memoryview.h"
+#include "memorycache.h"
+#include "debugmanager.h"
+
+#include <QBitArray>
+#include <QComboBox>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+#include <climits>
+
+constexpr int MemoryArea::BYTES_PER_ROW;
+constexpr int MemoryArea::PREFETCH_PAGES;
+
+MemoryArea::MemoryArea(MemoryCache *cache, QWidget *parent) :
+    QAbstractScrollArea(parent), m_cache(cache)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+}
+
+void MemoryArea::setRegion(quint64 base, quint64 size)
+{
+    m_base = base;
+    m_size = size;
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    fetchVisible();
+    viewport()->update();
+}
+
+int MemoryArea::rowCount() const
+{
+    auto rows = (m_size + BYTES_PER_ROW - 1) / BYTES_PER_ROW;
+    return int(qMin(rows, quint64(INT_MAX)));
+}
+
+int MemoryArea::visibleRows() const
+{
+    return viewport()->height() / fontMetrics().height() + 1;
+}
+
+void MemoryArea::updateScrollBars()
+{
+    auto fm = fontMetrics();
+    int lineWidth = fm.width(QLatin1Char('0')) * (18 + BYTES_PER_ROW * 4 + 4);
+    verticalScrollBar()->setRange(0, qMax(0, rowCount() - visibleRows() + 1));
+    verticalScrollBar()->setPageStep(visibleRows());
+    verticalScrollBar()->setSingleStep(1);
+    horizontalScrollBar()->setRange(0, qMax(0, lineWidth - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+}
+
+void MemoryArea::fetchVisible(int direction)
+{
+    if (m_size == 0)
+        return;
+    auto end = m_base + m_size;
+    auto start = m_base + quint64(verticalScrollBar()->value()) * BYTES_PER_ROW;
+    auto len = quint64(visibleRows()) * BYTES_PER_ROW;
+    if (start >= end)
+        return;
+    m_cache->fetch(start, qMin(len, end - start));
+    // Read ahead in the direction of the scroll so the next page is already there
+    auto prefetch = quint64(PREFETCH_PAGES) * MemoryCache::PAGE_SIZE;
+    if (direction >= 0) {
+        auto from = qMin(start + len, end);
+        m_cache->prefetch(from, qMin(prefetch, end - from));
+    } else {
+        auto back = qMin(prefetch, start - m_base);
+        m_cache->prefetch(start - back, back);
+    }
+}
+
+void MemoryArea::regionUpdated(quint64 addr, quint64 len)
+{
+    auto first = m_base + quint64(verticalScrollBar()->value()) * BYTES_PER_ROW;
+    auto last = first + quint64(visibleRows()) * BYTES_PER_ROW;
+    if (addr < last && addr + len > first) {
+        // =memory-changed drops the pages, read them again; pages already
+        // cached or pending are not asked twice
+        fetchVisible();
+        viewport()->update();
+    }
+}
+
+void MemoryArea::paintEvent(QPaintEvent *)
+{
+    QPainter p(viewport());
+    auto fm = fontMetrics();
+    int lineHeight = fm.height();
+    int x = -horizontalScrollBar()->value();
+    int firstRow = verticalScrollBar()->value();
+    int rows = qMin(visibleRows(), rowCount() - firstRow);
+    QByteArray bytes;
+    QBitArray valid;
+    for (int row = 0; row < rows; row++) {
+        auto addr = m_base + quint64(firstRow + row) * BYTES_PER_ROW;
+        int n = int(qMin(quint64(BYTES_PER_ROW), m_base + m_size - addr));
+        bool cached = m_cache->read(addr, n, &bytes, &valid);
+        QString hex;
+        QString ascii;
+        hex.reserve(BYTES_PER_ROW * 3);
+        ascii.reserve(BYTES_PER_ROW);
+        for (int i = 0; i < BYTES_PER_ROW; i++) {
+            if (i >= n) {
+                hex += QLatin1String("   ");
+                continue;
+            }
+            if (valid.testBit(i)) {
+                auto b = uchar(bytes.at(i));
+                hex += QString{"%1 "}.arg(uint(b), 2, 16, QChar{'0'});
+                ascii += (b >= 0x20 && b < 0x7f)? QChar{b} : QChar{'.'};
+            } else {
+                hex += cached? QLatin1String("?? ") : QLatin1String("   ");
+                ascii += ' ';
+            }
+        }
+        auto text = QString{"%1  %2 %3"}
+                .arg(addr, 16, 16, QChar{'0'})
+                .arg(hex, ascii);
+        p.drawText(x, row * lineHeight + fm.ascent(), text);
+    }
+}
+
+void MemoryArea::resizeEvent(QResizeEvent *e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    updateScrollBars();
+    fetchVisible();
+}
+
+void MemoryArea::scrollContentsBy(int, int dy)
+{
+    // dy is negative when scrolling towards higher addresses
+    fetchVisible(dy > 0? -1 : 1);
+    viewport()->update();
+}
+
+MemoryView::MemoryView(QWidget *parent) :
+    QWidget(parent),
+    m_cache(new MemoryCache(this)),
+    m_area(new MemoryArea(m_cache, this)),
+    m_address(new QLineEdit(this)),
+    m_size(new QComboBox(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    auto buttonGo = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    m_address->setPlaceholderText(tr("Address or expression"));
+    m_size->addItem(tr("4 KiB"), 4 << 10);
+    m_size->addItem(tr("64 KiB"), 64 << 10);
+    m_size->addItem(tr("1 MiB"), 1 << 20);
+    m_size->addItem(tr("16 MiB"), 16 << 20);
+    m_size->setCurrentIndex(1);
+    buttonGo->setIcon(QIcon{":/images/edit-find.svg"});
+    toolbar->addWidget(m_address);
+    toolbar->addWidget(m_size);
+    toolbar->addWidget(buttonGo);
+    layout->addLayout(toolbar);
+    layout->addWidget(m_area);
+
+    connect(m_address, &QLineEdit::returnPressed, this, &MemoryView::gotoClicked);
+    connect(buttonGo, &QToolButton::clicked, this, &MemoryView::gotoClicked);
+    connect(m_cache, &MemoryCache::updated, [this](quint64 addr, quint64 len) {
+        m_area->regionUpdated(addr, len);
+    });
+    connect(m_cache, &MemoryCache::invalidated, [this]() {
+        m_area->fetchVisible();
+        m_area->viewport()->update();
+    });
+}
+
+void MemoryView::setDebugManager(DebugManager *g)
+{
+    m_debug = g;
+    m_cache->setDebugManager(g);
+}
+
+void MemoryView::showAddress(quint64 addr, quint64 size)
+{
+    m_area->setRegion(addr, size);
+}
+
+void MemoryView::showExpression(const QString &expr)
+{
+    bool ok = false;
+    auto addr = expr.trimmed().toULongLong(&ok, 0);
+    if (ok) {
+        showAddress(addr, selectedSize());
+        return;
+    }
+    if (!m_debug)
+        return;
+    auto cmd = QString{"-data-evaluate-expression \"(unsigned long long)(%1)\""}.arg(expr);
+    m_debug->commandAndResponse(cmd, [this](const QVariant& r) {
+        bool ok = false;
+        auto addr = r.toMap().value("value").toString().toULongLong(&ok, 0);
+        if (ok)
+            showAddress(addr, selectedSize());
+    });
+}
+
+void MemoryView::clear()
+{
+    m_cache->invalidate();
+    m_area->setRegion(0, 0);
+    m_address->clear();
+}
+
+void MemoryView::gotoClicked()
+{
+    if (!m_address->text().isEmpty())
+        showExpression(m_address->text());
+}
+
+quint64 MemoryView::selectedSize() const
+{
+    return m_size->currentData().toULongLong();
+}
@@ -0,0 +1,66 @@
+#ifndef MEMORYVIEW_H
+#define MEMORYVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QWidget>
+
+class DebugManager;
+class MemoryCache;
+class QComboBox;
+class QLineEdit;
+
+class MemoryArea : public QAbstractScrollArea
+{
+public:
+    static constexpr int BYTES_PER_ROW = 16;
+    static constexpr int PREFETCH_PAGES = 8;
+
+    MemoryArea(MemoryCache *cache, QWidget *parent = nullptr);
+
+    void setRegion(quint64 base, quint64 size);
+    void fetchVisible(int direction = 0);
+    void regionUpdated(quint64 addr, quint64 len);
+
+protected:
+    virtual void paintEvent(QPaintEvent *e);
+    virtual void resizeEvent(QResizeEvent *e);
+    virtual void scrollContentsBy(int dx, int dy);
+
+private:
+    int rowCount() const;
+    int visibleRows() const;
+    void updateScrollBars();
+
+    MemoryCache *m_cache;
+    quint64 m_base = 0;
+    quint64 m_size = 0;
+};
+
+class MemoryView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    void showAddress(quint64 addr, quint64 size);
+    void showExpression(const QString& expr);
+    void clear();
+
+private slots:
+    void gotoClicked();
+
+private:
+    quint64 selectedSize() const;
+
+    DebugManager *m_debug = nullptr;
+    MemoryCache *m_cache;
+    MemoryArea *m_area;
+    QLineEdit *m_address;
+    QComboBox *m_size;
+};
+
+#endif // MEMORYVIEW_H
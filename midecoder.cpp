@@ -0,0 +1,72 @@
+#include "midecoder.h"
+
+#include <QByteArray>
+
+namespace mi {
+
+static int octalDigit(ushort c)
+{
+    return (c >= '0' && c <= '7')? c - '0' : -1;
+}
+
+// Decodes the C escapes gdb uses in MI c-strings from [it, end) into out.
+// Runs without escapes are appended in bulk; octal escapes are collected as
+// bytes and decoded together, since gdb writes non-ASCII text as octal UTF-8.
+// With quoted set, decoding stops after the first unescaped '"'. Returns the
+// position where decoding stopped.
+const QChar *unescape(const QChar *it, const QChar *end, bool quoted, QString *out)
+{
+    QByteArray bytes;
+    auto flushBytes = [&bytes, out]() {
+        if (!bytes.isEmpty()) {
+            // The QByteArray overload would stop at an escaped \000
+            out->append(QString::fromUtf8(bytes.constData(), bytes.size()));
+            bytes.clear();
+        }
+    };
+    out->reserve(out->size() + int(end - it));
+    while (it != end) {
+        auto run = it;
+        while (run != end && run->unicode() != '\\' && !(quoted && run->unicode() == '"'))
+            ++run;
+        if (run != it) {
+            flushBytes();
+            out->append(it, int(run - it));
+            it = run;
+        }
+        if (it == end)
+            break;
+        if (it->unicode() == '"') {
+            ++it;
+            break;
+        }
+        if (++it == end)
+            break;
+        auto c = it->unicode();
+        if (octalDigit(c) >= 0) {
+            int v = 0;
+            int d;
+            for (int n = 0; n < 3 && it != end && (d = octalDigit(it->unicode())) >= 0; n++, ++it)
+                v = v * 8 + d;
+            bytes.append(char(v));
+            continue;
+        }
+        flushBytes();
+        ++it;
+        switch (c) {
+        case 'n': out->append(QChar{'\n'}); break;
+        case 't': out->append(QChar{'\t'}); break;
+        case 'r': out->append(QChar{'\r'}); break;
+        case 'a': out->append(QChar{'\a'}); break;
+        case 'b': out->append(QChar{'\b'}); break;
+        case 'f': out->append(QChar{'\f'}); break;
+        case 'v': out->append(QChar{'\v'}); break;
+        case 'e': out->append(QChar{0x1b}); break;
+        default: out->append(QChar{c}); break;
+        }
+    }
+    flushBytes();
+    return it;
+}
+
+}
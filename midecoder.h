@@ -0,0 +1,123 @@
+#ifndef MIDECODER_H
+#define MIDECODER_H
+
+#include <QStringList>
+#include <QVariant>
+
+#include <cstddef>
+
+namespace mi {
+
+constexpr quint32 FNV_BASIS = 2166136261u;
+constexpr quint32 FNV_PRIME = 16777619u;
+
+// FNV-1a, usable on literals at compile time and on MI keys at run time
+constexpr quint32 hash(const char *s, quint32 h = FNV_BASIS)
+{
+    return *s? hash(s + 1, (h ^ quint32(uchar(*s))) * FNV_PRIME) : h;
+}
+
+// Decodes the C escapes of an MI c-string from [it, end) into out, stopping
+// after the closing '"' when quoted is set. Returns where decoding stopped.
+const QChar *unescape(const QChar *it, const QChar *end, bool quoted, QString *out);
+
+inline quint32 hash(const QString& s)
+{
+    quint32 h = FNV_BASIS;
+    for (const auto& c: s)
+        h = (h ^ quint32(c.unicode())) * FNV_PRIME;
+    return h;
+}
+
+// A switch label and its text. Switching on match() instead of hash() only
+// reaches a case when the string really is that label, so a hash collision
+// with a record name the switch does not know about falls into default
+struct Label {
+    quint32 hash;
+    const char *text;
+};
+
+constexpr Label label(const char *text)
+{
+    return { hash(text), text };
+}
+
+template<std::size_t N>
+quint32 match(const QString& s, const Label (&labels)[N])
+{
+    auto h = hash(s);
+    for (std::size_t i = 0; i < N; i++)
+        if (labels[i].hash == h)
+            return s == QLatin1String(labels[i].text)? h : 0;
+    return 0;
+}
+
+// One entry of a record description: the MI key, its hash and how to store
+// the value into the record
+template<typename T>
+struct Field {
+    quint32 hash;
+    const char *key;
+    void (*read)(T& out, const QVariant& v);
+};
+
+inline void convert(QString& out, const QVariant& v) { out = v.toString(); }
+inline void convert(int& out, const QVariant& v) { out = v.toInt(); }
+inline void convert(bool& out, const QVariant& v) { out = v.toBool(); }
+inline void convert(QList<QString>& out, const QVariant& v) { out = v.toStringList(); }
+inline void hexAddress(quint64& out, const QVariant& v) { out = v.toString().toULongLong(nullptr, 16); }
+
+template<typename T, typename M, M T::*member>
+void assign(T& out, const QVariant& v)
+{
+    convert(out.*member, v);
+}
+
+template<typename T, typename M, M T::*member, void (*conv)(M&, const QVariant&)>
+void assignWith(T& out, const QVariant& v)
+{
+    conv(out.*member, v);
+}
+
+template<typename T>
+constexpr Field<T> field(const char *key, void (*read)(T&, const QVariant&))
+{
+    return { hash(key), key, read };
+}
+
+// Walks the tuple once. Keys missing from it are decoded from an empty
+// value, which is what a QVariantMap::value() lookup would have returned.
+// Repeated keys iterate newest first, so like value() the first one wins.
+template<typename T, std::size_t N>
+T decode(const QVariantMap& data, const Field<T> (&fields)[N])
+{
+    static_assert(N <= 64, "record descriptions are limited to 64 fields");
+    T out;
+    quint64 seen = 0;
+    for (auto it = data.cbegin(); it != data.cend(); ++it) {
+        auto h = hash(it.key());
+        for (std::size_t i = 0; i < N; i++) {
+            if (fields[i].hash == h && it.key() == QLatin1String(fields[i].key)) {
+                if (!(seen & (quint64(1) << i)))
+                    fields[i].read(out, it.value());
+                seen |= quint64(1) << i;
+                break;
+            }
+        }
+    }
+    const quint64 all = ~quint64(0) >> (64 - N);
+    if (seen != all)
+        for (std::size_t i = 0; i < N; i++)
+            if (!(seen & (quint64(1) << i)))
+                fields[i].read(out, QVariant{});
+    return out;
+}
+
+}
+
+#define MI_FIELD(T, member, key) \
+    mi::field<T>(key, &mi::assign<T, decltype(T::member), &T::member>)
+#define MI_FIELD_WITH(T, member, key, conv) \
+    mi::field<T>(key, &mi::assignWith<T, decltype(T::member), &T::member, conv>)
+
+#endif // MIDECODER_H
@@ -0,0 +1,147 @@
+#include "parallelstacksview.h"
+#include "perfstats.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSpinBox>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+constexpr int ParallelStacksView::MAX_LISTED_THREADS;
+
+static QString frameName(const gdb::Frame& f)
+{
+    return f.func.isEmpty()? QString{"0x%1"}.arg(f.addr, 0, 16) : f.func;
+}
+
+ParallelStacksView::ParallelStacksView(QWidget *parent) :
+    QWidget(parent),
+    m_collector(new StackCollector(this)),
+    m_tree(new QTreeWidget(this)),
+    m_depth(new QSpinBox(this)),
+    m_buttonCollect(new QToolButton(this)),
+    m_status(new QLabel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto top = new QHBoxLayout;
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    top->setSpacing(1);
+
+    m_buttonCollect->setIcon(QIcon{":/images/edit-redo.svg"});
+    m_buttonCollect->setToolTip(tr("Collect the stacks of all threads"));
+    m_depth->setRange(0, 4096);
+    m_depth->setValue(0);
+    m_depth->setSpecialValueText(tr("Whole stacks"));
+    m_depth->setPrefix(tr("Depth "));
+    m_depth->setToolTip(tr("Frames walked per thread, less is faster on big processes"));
+    m_tree->setColumnCount(3);
+    m_tree->setHeaderLabels({ tr("Function"), tr("Threads"), tr("Location") });
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_tree->header()->setStretchLastSection(false);
+    m_tree->setUniformRowHeights(true);
+
+    top->addWidget(m_buttonCollect);
+    top->addWidget(m_depth);
+    top->addWidget(m_status, 1);
+    layout->addLayout(top);
+    layout->addWidget(m_tree);
+
+    connect(m_buttonCollect, &QToolButton::clicked, this, &ParallelStacksView::collect);
+    connect(m_collector, &StackCollector::collected, this, &ParallelStacksView::showStacks);
+    connect(m_collector, &StackCollector::failed, m_status, &QLabel::setText);
+    connect(m_collector, &StackCollector::progress, [this](int done, int total) {
+        m_status->setText(tr("%1/%2 threads").arg(done).arg(total));
+    });
+    connect(m_tree, &QTreeWidget::itemActivated, [this](QTreeWidgetItem *item) {
+        auto frame = m_stacks.node(item->data(0, Qt::UserRole).toInt()).frame;
+        if (!frame.fullpath.isEmpty())
+            emit locationActivated(frame.fullpath, frame.line);
+    });
+}
+
+void ParallelStacksView::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_collector->setDebugManager(g);
+    clear();
+    if (!g)
+        return;
+    // The merged tree describes one stop only
+    connect(g, &DebugManager::asyncRunning, this, &ParallelStacksView::clear);
+    connect(g, &DebugManager::terminated, this, &ParallelStacksView::clear);
+}
+
+void ParallelStacksView::collect()
+{
+    m_clock.start();
+    m_status->setText(tr("Listing threads..."));
+    m_collector->collect(m_depth->value());
+}
+
+void ParallelStacksView::clear()
+{
+    m_tree->clear();
+    m_stacks.clear();
+    m_status->clear();
+}
+
+void ParallelStacksView::showStacks(const QList<StackCollector::ThreadStack> &stacks)
+{
+    PERF_SCOPE("ParallelStacksView::showStacks");
+    m_tree->clear();
+    m_stacks.clear();
+    for (const auto& s: stacks)
+        m_stacks.add(s.frames, s.thread, s.truncated);
+    m_tree->setUpdatesEnabled(false);
+    for (auto child: m_stacks.children(0))
+        addNode(child, nullptr);
+    m_tree->setUpdatesEnabled(true);
+    m_tree->resizeColumnToContents(1);
+    m_tree->resizeColumnToContents(2);
+    m_status->setText(tr("%1 threads, %2 distinct stacks, %3 ms")
+                      .arg(stacks.size()).arg(m_stacks.uniqueStacks()).arg(m_clock.elapsed()));
+}
+
+void ParallelStacksView::addNode(int node, QTreeWidgetItem *parent)
+{
+    // A run of frames all threads of the branch share becomes a single row
+    // named after its innermost frame, the whole run goes to the tooltip
+    QStringList run;
+    int last = node;
+    for (;;) {
+        const auto& n = m_stacks.node(last);
+        run.prepend(frameName(n.frame));
+        if (n.children.size() != 1 || n.leafCount > 0)
+            break;
+        int next = n.children.cbegin().value();
+        if (m_stacks.node(next).count != n.count)
+            break;
+        last = next;
+    }
+    const auto& n = m_stacks.node(last);
+    auto item = parent? new QTreeWidgetItem(parent) : new QTreeWidgetItem(m_tree);
+    auto name = frameName(n.frame);
+    if (run.size() > 1)
+        name += tr("  (+%1 frames)").arg(run.size() - 1);
+    item->setText(0, name);
+    item->setText(1, QString::number(n.count));
+    item->setTextAlignment(1, Qt::AlignRight);
+    if (!n.frame.file.isEmpty())
+        item->setText(2, QString{"%1:%2"}.arg(n.frame.file).arg(n.frame.line));
+    item->setData(0, Qt::UserRole, last);
+    QStringList threads;
+    for (int i = 0; i < n.threads.size() && i < MAX_LISTED_THREADS; i++)
+        threads.append(QString::number(n.threads.at(i)));
+    if (n.threads.size() > MAX_LISTED_THREADS)
+        threads.append("...");
+    item->setToolTip(0, run.join('\n'));
+    item->setToolTip(1, tr("Threads %1").arg(threads.join(", ")));
+    for (auto child: m_stacks.children(last))
+        addNode(child, item);
+    item->setExpanded(true);
+}
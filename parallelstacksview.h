@@ -0,0 +1,48 @@
+#ifndef PARALLELSTACKSVIEW_H
+#define PARALLELSTACKSVIEW_H
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include "stackcollector.h"
+
+class QLabel;
+class QSpinBox;
+class QToolButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class ParallelStacksView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // Threads listed in a tooltip before it is cut short
+    static constexpr int MAX_LISTED_THREADS = 32;
+
+    explicit ParallelStacksView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+signals:
+    void locationActivated(const QString& fullpath, int line);
+
+private slots:
+    void collect();
+    void showStacks(const QList<StackCollector::ThreadStack>& stacks);
+    void clear();
+
+private:
+    void addNode(int node, QTreeWidgetItem *parent);
+
+    DebugManager *m_debug = nullptr;
+    StackCollector *m_collector;
+    StackTree m_stacks;
+    QTreeWidget *m_tree;
+    QSpinBox *m_depth;
+    QToolButton *m_buttonCollect;
+    QLabel *m_status;
+    QElapsedTimer m_clock;
+};
+
+#endif // PARALLELSTACKSVIEW_H
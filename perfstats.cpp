@@ -0,0 +1,119 @@
+#include "perfstats.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace perf {
+
+bool enabled = false;
+
+constexpr int Stats::MAX_EVENTS;
+
+Stats::Stats()
+{
+    m_clock.start();
+}
+
+Stats *Stats::instance()
+{
+    static Stats *self = nullptr;
+    if (!self)
+        self = new Stats;
+    return self;
+}
+
+void Stats::setEnabled(bool on)
+{
+    enabled = on;
+}
+
+void Stats::addTime(const QString &name, qint64 startNs, qint64 durationNs)
+{
+    auto& e = m_timers[name];
+    e.count++;
+    e.totalNs += durationNs;
+    e.maxNs = qMax(e.maxNs, durationNs);
+    addEvent({ Event::Complete, name, startNs, durationNs, 0 });
+}
+
+void Stats::addCount(const QString &name, qint64 delta)
+{
+    auto& c = m_counters[name];
+    c += delta;
+    addEvent({ Event::Counter, name, now(), c, 0 });
+}
+
+void Stats::addAsync(const QString &name, int id, qint64 startNs, qint64 durationNs)
+{
+    auto& e = m_timers[name];
+    e.count++;
+    e.totalNs += durationNs;
+    e.maxNs = qMax(e.maxNs, durationNs);
+    addEvent({ Event::Async, name, startNs, durationNs, id });
+}
+
+void Stats::addEvent(const Event &e)
+{
+    // Aggregates keep counting, only the timeline stops growing
+    if (m_events.size() >= MAX_EVENTS) {
+        m_truncated = true;
+        return;
+    }
+    m_events.append(e);
+}
+
+void Stats::clear()
+{
+    m_timers.clear();
+    m_counters.clear();
+    m_events.clear();
+    m_truncated = false;
+}
+
+bool Stats::exportTrace(const QString &path) const
+{
+    QFile f{path};
+    if (!f.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    QJsonArray events;
+    for (const auto& e: m_events) {
+        QJsonObject o{
+            { "name", e.name },
+            { "pid", 1 },
+            { "tid", 1 },
+            { "ts", double(e.start) / 1000.0 },
+        };
+        switch (e.kind) {
+        case Event::Complete:
+            o.insert("ph", "X");
+            o.insert("cat", "gui");
+            o.insert("dur", double(e.value) / 1000.0);
+            events.append(o);
+            break;
+        case Event::Counter:
+            o.insert("ph", "C");
+            o.insert("args", QJsonObject{{ "value", double(e.value) }});
+            events.append(o);
+            break;
+        case Event::Async: {
+            o.insert("cat", "mi");
+            o.insert("id", e.id);
+            o.insert("ph", "b");
+            events.append(o);
+            o.insert("ph", "e");
+            o.insert("ts", double(e.start + e.value) / 1000.0);
+            events.append(o);
+            break;
+        }
+        }
+    }
+    QJsonObject root{
+        { "traceEvents", events },
+        { "displayTimeUnit", "ms" },
+    };
+    return f.write(QJsonDocument{root}.toJson(QJsonDocument::Compact)) != -1;
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace perf {
+
+// Checked inline by every probe, recording costs one branch while off
+extern bool enabled;
+
+struct Entry {
+    quint64 count = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+};
+
+class Stats
+{
+public:
+    static constexpr int MAX_EVENTS = 200000;
+
+    static Stats *instance();
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+
+    void addTime(const QString& name, qint64 startNs, qint64 durationNs);
+    void addCount(const QString& name, qint64 delta);
+    // Overlapping intervals, such as command round trips, identified by id
+    void addAsync(const QString& name, int id, qint64 startNs, qint64 durationNs);
+
+    const QHash<QString, Entry>& timers() const { return m_timers; }
+    const QHash<QString, qint64>& counters() const { return m_counters; }
+    int eventCount() const { return m_events.size(); }
+    bool isTruncated() const { return m_truncated; }
+
+    void clear();
+    // Chrome trace event format, loadable in chrome://tracing and Perfetto
+    bool exportTrace(const QString& path) const;
+
+private:
+    Stats();
+
+    struct Event {
+        enum Kind_t { Complete, Async, Counter } kind;
+        QString name;
+        qint64 start;
+        qint64 value;
+        int id;
+    };
+
+    void addEvent(const Event& e);
+
+    QElapsedTimer m_clock;
+    QHash<QString, Entry> m_timers;
+    QHash<QString, qint64> m_counters;
+    QVector<Event> m_events;
+    bool m_truncated = false;
+};
+
+class Scope
+{
+public:
+    explicit Scope(const char *name) : m_name(enabled? name : nullptr)
+    {
+        if (m_name)
+            m_start = Stats::instance()->now();
+    }
+    ~Scope()
+    {
+        if (m_name) {
+            auto s = Stats::instance();
+            s->addTime(QString::fromLatin1(m_name), m_start, s->now() - m_start);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(Scope)
+    const char *m_name;
+    qint64 m_start = 0;
+};
+
+inline void count(const char *name, qint64 delta = 1)
+{
+    if (enabled)
+        Stats::instance()->addCount(QString::fromLatin1(name), delta);
+}
+
+}
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(name) perf::Scope PERF_CONCAT(perfScope_, __LINE__){name}
+
+#endif // PERFSTATS_H
@@ -0,0 +1,121 @@
+#include "perfview.h"
+#include "perfstats.h"
+
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QTimer>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace conf {
+namespace perfview {
+
+constexpr int REFRESH_INTERVAL = 500;
+
+}
+}
+
+PerfView::PerfView(QWidget *parent) :
+    QWidget(parent),
+    m_enabled(new QCheckBox(tr("Record"), this)),
+    m_tree(new QTreeWidget(this)),
+    m_status(new QLabel(this)),
+    m_timer(new QTimer(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto bar = new QHBoxLayout;
+    auto buttonReset = new QToolButton(this);
+    auto buttonExport = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    bar->setSpacing(1);
+
+    buttonReset->setText(tr("Reset"));
+    buttonExport->setText(tr("Export trace..."));
+    buttonExport->setToolTip(tr("Save a Chrome trace / Perfetto JSON file"));
+    m_enabled->setChecked(perf::enabled);
+    m_tree->setHeaderLabels({ tr("Probe"), tr("Count"), tr("Total ms"), tr("Avg us"), tr("Max us") });
+    m_tree->setRootIsDecorated(false);
+    m_tree->setSortingEnabled(true);
+    m_tree->sortByColumn(2, Qt::DescendingOrder);
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    bar->addWidget(m_enabled);
+    bar->addWidget(buttonReset);
+    bar->addWidget(buttonExport);
+    bar->addWidget(m_status, 1);
+    layout->addLayout(bar);
+    layout->addWidget(m_tree);
+
+    m_timer->setInterval(conf::perfview::REFRESH_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &PerfView::refresh);
+    connect(m_enabled, &QCheckBox::toggled, [](bool on) { perf::Stats::instance()->setEnabled(on); });
+    connect(buttonReset, &QToolButton::clicked, [this]() {
+        perf::Stats::instance()->clear();
+        refresh();
+    });
+    connect(buttonExport, &QToolButton::clicked, this, &PerfView::exportTrace);
+}
+
+void PerfView::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+    m_enabled->setChecked(perf::enabled);
+    refresh();
+    m_timer->start();
+}
+
+void PerfView::hideEvent(QHideEvent *e)
+{
+    QWidget::hideEvent(e);
+    m_timer->stop();
+}
+
+static QTreeWidgetItem *numericItem(const QString& name)
+{
+    auto item = new QTreeWidgetItem(QStringList{ name });
+    for (int col = 1; col < 5; col++)
+        item->setTextAlignment(col, Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+void PerfView::refresh()
+{
+    auto s = perf::Stats::instance();
+    m_tree->setSortingEnabled(false);
+    m_tree->clear();
+    const auto& timers = s->timers();
+    for (auto it = timers.cbegin(); it != timers.cend(); ++it) {
+        const auto& e = it.value();
+        auto item = numericItem(it.key());
+        item->setData(1, Qt::DisplayRole, e.count);
+        item->setData(2, Qt::DisplayRole, e.totalNs / 1e6);
+        item->setData(3, Qt::DisplayRole, e.count? e.totalNs / 1e3 / e.count : 0.0);
+        item->setData(4, Qt::DisplayRole, e.maxNs / 1e3);
+        m_tree->addTopLevelItem(item);
+    }
+    const auto& counters = s->counters();
+    for (auto it = counters.cbegin(); it != counters.cend(); ++it) {
+        auto item = numericItem(it.key());
+        item->setData(1, Qt::DisplayRole, it.value());
+        m_tree->addTopLevelItem(item);
+    }
+    m_tree->setSortingEnabled(true);
+    m_status->setText(s->isTruncated()? tr("%1 events, timeline full").arg(s->eventCount()) :
+                                        tr("%1 events").arg(s->eventCount()));
+}
+
+void PerfView::exportTrace()
+{
+    auto path = QFileDialog::getSaveFileName(this, tr("Export trace"), "gdbfront-trace.json",
+                                             tr("Trace files (*.json)"));
+    if (path.isEmpty())
+        return;
+    if (!perf::Stats::instance()->exportTrace(path))
+        QMessageBox::warning(this, tr("Export trace"), tr("Cannot write %1").arg(path));
+}
@@ -0,0 +1,33 @@
+#ifndef PERFVIEW_H
+#define PERFVIEW_H
+
+#include <QWidget>
+
+class QCheckBox;
+class QLabel;
+class QTreeWidget;
+class QTimer;
+
+class PerfView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerfView(QWidget *parent = nullptr);
+
+protected:
+    virtual void showEvent(QShowEvent *e);
+    virtual void hideEvent(QHideEvent *e);
+
+private slots:
+    void refresh();
+    void exportTrace();
+
+private:
+    QCheckBox *m_enabled;
+    QTreeWidget *m_tree;
+    QLabel *m_status;
+    QTimer *m_timer;
+};
+
+#endif // PERFVIEW_H
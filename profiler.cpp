@@ -0,0 +1,189 @@
+#include "profiler.h"
+#include "perfstats.h"
+
+#include <QTimer>
+
+constexpr int Profiler::MIN_INTERVAL;
+constexpr int Profiler::MAX_INTERVAL;
+constexpr int Profiler::DEFAULT_DEPTH;
+constexpr int Profiler::DEFAULT_BUDGET;
+
+namespace conf {
+namespace profiler {
+
+// Weight of the newest pause in its moving average
+constexpr double PAUSE_SMOOTHING = 0.2;
+
+}
+}
+
+Profiler::Profiler(QObject *parent) :
+    QObject(parent),
+    m_collector(new StackCollector(this)),
+    m_timer(new QTimer(this)),
+    // The pc of an interrupt lands anywhere in a function
+    m_tree(StackTree::ByFunction)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &Profiler::interrupt);
+    connect(m_collector, &StackCollector::collected, this, &Profiler::collected);
+    connect(m_collector, &StackCollector::failed, this, [this](const QString& msg) {
+        finish(msg);
+    });
+}
+
+void Profiler::setDebugManager(DebugManager *g)
+{
+    finish();
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    m_collector->setDebugManager(g);
+    clear();
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncStopped, this, &Profiler::stopped);
+    connect(g, &DebugManager::terminated, this, [this]() { finish(); });
+}
+
+int Profiler::interval() const
+{
+    // pause / interval must stay below budget / 1000
+    return qBound(MIN_INTERVAL, int(m_pauseEma * 1000 / m_budget), MAX_INTERVAL);
+}
+
+void Profiler::start()
+{
+    if (isActive())
+        return;
+    if (!m_debug || !m_debug->isGdbExecuting()) {
+        emit error(tr("No inferior to profile"));
+        return;
+    }
+    m_state = Running;
+    if (!m_debug->isInferiorRunning())
+        m_debug->commandContinue();
+    m_timer->start(interval());
+    emit activeChanged(true);
+}
+
+void Profiler::stop()
+{
+    finish();
+}
+
+void Profiler::clear()
+{
+    m_tree.clear();
+    m_samples = 0;
+    m_pauseEma = 0;
+    emit sampled();
+}
+
+void Profiler::interrupt()
+{
+    if (m_state != Running)
+        return;
+    if (!m_debug->isInferiorRunning()) {
+        finish(tr("The inferior stopped on its own"));
+        return;
+    }
+    m_state = Interrupting;
+    m_pauseClock.start();
+    m_debug->commandInterrupt();
+}
+
+void Profiler::stopped(const gdb::AsyncContext &ctx)
+{
+    using Reason = gdb::AsyncContext::Reason;
+    if (!isActive())
+        return;
+    switch (ctx.reason) {
+    case Reason::exited:
+    case Reason::exitedNormally:
+    case Reason::exitedSignalled:
+        finish(tr("The inferior exited"));
+        return;
+    default:
+        break;
+    }
+    bool interrupted = ctx.reason == Reason::signalReceived;
+    if (m_state == Settling && interrupted) {
+        // Stops before the thread states arrived are counted in them already
+        if (m_awaitedStops > 0 && --m_awaitedStops == 0)
+            startCollecting();
+        return;
+    }
+    if (m_state != Interrupting || !interrupted) {
+        // A breakpoint or a crash is for the user to look at, not to sample
+        // over, so finish() must not resume the inferior
+        m_state = Running;
+        finish(tr("Stopped: %1").arg(gdb::AsyncContext::reasonToText(ctx.reason)));
+        return;
+    }
+    if (m_debug->isNonStop())
+        settle();
+    else
+        startCollecting();
+}
+
+void Profiler::settle()
+{
+    // Non-stop gdb reports the interrupt with one *stopped per thread, and
+    // every further one would cancel a collection already started
+    m_state = Settling;
+    m_awaitedStops = -1;
+    m_debug->enqueue("-thread-info", DebugManager::Priority_t::Interactive, [this](const QVariant& r) {
+        if (m_state != Settling)
+            return;
+        int running = 0;
+        for (const auto& e: r.toMap().value("threads").toList())
+            if (gdb::Thread::parseMap(e.toMap()).state == gdb::Thread::Running)
+                running++;
+        m_awaitedStops = running;
+        if (running == 0)
+            startCollecting();
+    }, [this](const QVariant& r) {
+        if (m_state == Settling)
+            finish(r.toMap().value("msg").toString());
+    }, DebugManager::Delivery_t::HandlerOnly);
+}
+
+void Profiler::startCollecting()
+{
+    m_state = Collecting;
+    m_collector->collect(m_depth);
+}
+
+void Profiler::collected(const QList<StackCollector::ThreadStack> &stacks)
+{
+    PERF_SCOPE("Profiler::collected");
+    if (m_state != Collecting)
+        return;
+    for (const auto& s: stacks)
+        m_tree.add(s.frames, -1, s.truncated);
+    m_samples++;
+    double pause = m_pauseClock.elapsed();
+    m_pauseEma = m_samples == 1? pause : m_pauseEma + conf::profiler::PAUSE_SMOOTHING * (pause - m_pauseEma);
+    perf::count("profiler.samples");
+    m_state = Running;
+    m_debug->commandContinue();
+    m_timer->start(interval());
+    emit sampled();
+}
+
+void Profiler::finish(const QString &msg)
+{
+    if (!isActive())
+        return;
+    m_timer->stop();
+    m_collector->cancel();
+    // An interrupted inferior goes back to running, as it was before
+    if ((m_state == Collecting || m_state == Settling) && m_debug)
+        m_debug->commandContinue();
+    m_state = Idle;
+    emit finished();
+    emit activeChanged(false);
+    if (!msg.isEmpty())
+        emit error(msg);
+}
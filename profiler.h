@@ -0,0 +1,76 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+
+#include "stackcollector.h"
+
+class QTimer;
+
+// Poor man's sampling profiler: interrupt, collect the stacks of all threads,
+// continue. The interval follows the measured pause so that the inferior is
+// stopped at most budget ms per second of wall time.
+class Profiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MIN_INTERVAL = 10;
+    static constexpr int MAX_INTERVAL = 5000;
+    static constexpr int DEFAULT_DEPTH = 64;
+    static constexpr int DEFAULT_BUDGET = 100;
+
+    explicit Profiler(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+    bool isActive() const { return m_state != Idle; }
+    const StackTree& tree() const { return m_tree; }
+    int samples() const { return m_samples; }
+    // Mean pause per sample and current interval, in ms
+    double pause() const { return m_pauseEma; }
+    int interval() const;
+
+public slots:
+    void start();
+    void stop();
+    void clear();
+    void setDepth(int frames) { m_depth = frames; }
+    void setBudget(int msPerSecond) { m_budget = qMax(1, msPerSecond); }
+
+signals:
+    void activeChanged(bool active);
+    void sampled();
+    // Sampling ended, tree() holds every sample
+    void finished();
+    void error(const QString& msg);
+
+private slots:
+    void interrupt();
+    void stopped(const gdb::AsyncContext& ctx);
+    void collected(const QList<StackCollector::ThreadStack>& stacks);
+
+private:
+    // Settling: non-stop only, waiting for the *stopped of every thread
+    enum State_t { Idle, Running, Interrupting, Settling, Collecting };
+
+    void settle();
+    void startCollecting();
+    void finish(const QString& msg = {});
+
+    DebugManager *m_debug = nullptr;
+    StackCollector *m_collector;
+    QTimer *m_timer;
+    QElapsedTimer m_pauseClock;
+    StackTree m_tree;
+    State_t m_state = Idle;
+    int m_samples = 0;
+    // Stops still to come while Settling, -1 until the thread states are known
+    int m_awaitedStops = -1;
+    int m_depth = DEFAULT_DEPTH;
+    int m_budget = DEFAULT_BUDGET;
+    double m_pauseEma = 0;
+};
+
+#endif // PROFILER_H
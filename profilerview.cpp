@@ -0,0 +1,283 @@
+#include "profilerview.h"
+#include "profiler.h"
+#include "perfstats.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollArea>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QToolButton>
+#include <QToolTip>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+constexpr int FlameGraph::ROW_HEIGHT;
+
+namespace conf {
+namespace flame {
+
+// Narrower boxes are not drawn, nor are their children
+constexpr double MIN_WIDTH = 1.0;
+constexpr int TEXT_MARGIN = 3;
+
+}
+}
+
+static QString frameName(const gdb::Frame& f)
+{
+    return f.func.isEmpty()? QString{"0x%1"}.arg(f.addr, 0, 16) : f.func;
+}
+
+FlameGraph::FlameGraph(const StackTree *tree, QWidget *parent) :
+    QWidget(parent), m_tree(tree)
+{
+    setMouseTracking(true);
+    setAutoFillBackground(true);
+    setBackgroundRole(QPalette::Base);
+}
+
+void FlameGraph::refresh()
+{
+    if (m_zoom >= m_tree->size())
+        m_zoom = 0;
+    setMinimumHeight((depthBelow(m_zoom) + 1) * ROW_HEIGHT);
+    update();
+}
+
+void FlameGraph::setZoom(int node)
+{
+    m_zoom = node;
+    refresh();
+}
+
+int FlameGraph::depthBelow(int node) const
+{
+    int depth = 0;
+    for (auto child: m_tree->node(node).children)
+        depth = qMax(depth, 1 + depthBelow(child));
+    return depth;
+}
+
+void FlameGraph::layoutNode(int node, double x, double width, int depth)
+{
+    m_boxes.append({ QRectF{x, height() - (depth + 1) * ROW_HEIGHT, width, ROW_HEIGHT}, node });
+    const auto& n = m_tree->node(node);
+    if (n.count == 0)
+        return;
+    for (auto child: m_tree->children(node)) {
+        double w = width * m_tree->node(child).count / n.count;
+        if (w < conf::flame::MIN_WIDTH)
+            break;
+        layoutNode(child, x, w, depth + 1);
+        x += w;
+    }
+}
+
+void FlameGraph::paintEvent(QPaintEvent *)
+{
+    PERF_SCOPE("FlameGraph::paintEvent");
+    m_boxes.clear();
+    if (m_tree->node(m_zoom).count == 0)
+        return;
+    layoutNode(m_zoom, 0, width(), 0);
+    QPainter p(this);
+    auto fm = fontMetrics();
+    for (const auto& box: m_boxes) {
+        auto name = box.node == 0? tr("all") : frameName(m_tree->node(box.node).frame);
+        // Stable warm colours, the same function keeps its colour between runs
+        auto h = qHash(name);
+        p.fillRect(box.rect.adjusted(0, 0, -1, -1),
+                   QColor::fromHsv(int(h % 50), 120 + int((h >> 8) % 100), 230));
+        if (box.rect.width() > 2 * conf::flame::TEXT_MARGIN + fm.averageCharWidth()) {
+            auto r = box.rect.adjusted(conf::flame::TEXT_MARGIN, 0, -conf::flame::TEXT_MARGIN, 0);
+            p.drawText(r, Qt::AlignVCenter | Qt::AlignLeft, fm.elidedText(name, Qt::ElideRight, int(r.width())));
+        }
+    }
+}
+
+int FlameGraph::nodeAt(const QPoint &pos) const
+{
+    for (const auto& box: m_boxes)
+        if (box.rect.contains(pos))
+            return box.node;
+    return -1;
+}
+
+void FlameGraph::mousePressEvent(QMouseEvent *e)
+{
+    int node = nodeAt(e->pos());
+    // Clicking the bottom box zooms back out one level
+    if (node == m_zoom && node != 0)
+        node = m_tree->node(node).parent;
+    if (node != -1)
+        setZoom(node);
+}
+
+void FlameGraph::mouseDoubleClickEvent(QMouseEvent *e)
+{
+    int node = nodeAt(e->pos());
+    if (node > 0)
+        emit nodeActivated(node);
+}
+
+bool FlameGraph::event(QEvent *e)
+{
+    if (e->type() == QEvent::ToolTip) {
+        auto help = static_cast<QHelpEvent*>(e);
+        int node = nodeAt(help->pos());
+        if (node > 0) {
+            const auto& n = m_tree->node(node);
+            auto total = m_tree->node(0).count;
+            QToolTip::showText(help->globalPos(), tr("%1\n%2 samples, %3%")
+                               .arg(frameName(n.frame)).arg(n.count)
+                               .arg(100.0 * n.count / qMax(1, total), 0, 'f', 1), this);
+        } else {
+            QToolTip::hideText();
+        }
+        return true;
+    }
+    return QWidget::event(e);
+}
+
+ProfilerView::ProfilerView(QWidget *parent) :
+    QWidget(parent),
+    m_profiler(new Profiler(this)),
+    m_flame(new FlameGraph(&m_profiler->tree(), this)),
+    m_callTree(new QTreeWidget(this)),
+    m_depth(new QSpinBox(this)),
+    m_budget(new QSpinBox(this)),
+    m_buttonRun(new QToolButton(this)),
+    m_status(new QLabel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto top = new QHBoxLayout;
+    auto buttonClear = new QToolButton(this);
+    auto splitter = new QSplitter(Qt::Vertical, this);
+    auto scroll = new QScrollArea(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    top->setSpacing(1);
+
+    m_buttonRun->setIcon(QIcon{":/images/debug-run-v2.svg"});
+    m_buttonRun->setToolTip(tr("Start/stop sampling"));
+    buttonClear->setIcon(QIcon{":/images/list-remove.svg"});
+    buttonClear->setToolTip(tr("Drop the collected samples"));
+    m_depth->setRange(1, 4096);
+    m_depth->setValue(Profiler::DEFAULT_DEPTH);
+    m_depth->setPrefix(tr("Depth "));
+    m_depth->setToolTip(tr("Frames collected per thread and sample"));
+    m_budget->setRange(1, 1000);
+    m_budget->setValue(Profiler::DEFAULT_BUDGET);
+    m_budget->setSuffix(tr(" ms/s"));
+    m_budget->setToolTip(tr("Time the inferior may spend stopped per second, the sampling rate follows"));
+    scroll->setWidget(m_flame);
+    scroll->setWidgetResizable(true);
+    m_callTree->setColumnCount(4);
+    m_callTree->setHeaderLabels({ tr("Function"), tr("Total"), tr("Self"), tr("Location") });
+    m_callTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_callTree->header()->setStretchLastSection(false);
+    m_callTree->setUniformRowHeights(true);
+
+    top->addWidget(m_buttonRun);
+    top->addWidget(buttonClear);
+    top->addWidget(m_depth);
+    top->addWidget(m_budget);
+    top->addWidget(m_status, 1);
+    splitter->addWidget(scroll);
+    splitter->addWidget(m_callTree);
+    layout->addLayout(top);
+    layout->addWidget(splitter);
+
+    connect(m_buttonRun, &QToolButton::clicked, [this]() {
+        if (m_profiler->isActive())
+            m_profiler->stop();
+        else
+            m_profiler->start();
+    });
+    connect(buttonClear, &QToolButton::clicked, m_profiler, &Profiler::clear);
+    connect(m_depth, QOverload<int>::of(&QSpinBox::valueChanged), m_profiler, &Profiler::setDepth);
+    connect(m_budget, QOverload<int>::of(&QSpinBox::valueChanged), m_profiler, &Profiler::setBudget);
+    connect(m_profiler, &Profiler::sampled, m_flame, &FlameGraph::refresh);
+    connect(m_profiler, &Profiler::sampled, this, &ProfilerView::updateStatus);
+    connect(m_profiler, &Profiler::finished, m_flame, &FlameGraph::refresh);
+    connect(m_profiler, &Profiler::finished, this, &ProfilerView::updateCallTree);
+    connect(m_profiler, &Profiler::error, m_status, &QLabel::setText);
+    connect(m_profiler, &Profiler::activeChanged, [this](bool active) {
+        m_buttonRun->setIcon(QIcon{active? ":/images/debug-pause-v2.svg" : ":/images/debug-run-v2.svg"});
+        if (active)
+            m_callTree->clear();
+        updateStatus();
+        emit samplingChanged(active);
+    });
+    connect(m_flame, &FlameGraph::nodeActivated, this, &ProfilerView::activateNode);
+    connect(m_callTree, &QTreeWidget::itemActivated, [this](QTreeWidgetItem *item) {
+        activateNode(item->data(0, Qt::UserRole).toInt());
+    });
+}
+
+void ProfilerView::setDebugManager(DebugManager *g)
+{
+    m_profiler->setDebugManager(g);
+    m_callTree->clear();
+    m_flame->setZoom(0);
+}
+
+bool ProfilerView::isSampling() const
+{
+    return m_profiler->isActive();
+}
+
+void ProfilerView::updateStatus()
+{
+    if (!m_profiler->isActive() && m_profiler->samples() == 0) {
+        m_status->clear();
+        return;
+    }
+    m_status->setText(tr("%1 samples, %2 ms pause, every %3 ms")
+                      .arg(m_profiler->samples())
+                      .arg(m_profiler->pause(), 0, 'f', 1)
+                      .arg(m_profiler->interval()));
+}
+
+void ProfilerView::updateCallTree()
+{
+    PERF_SCOPE("ProfilerView::updateCallTree");
+    m_callTree->clear();
+    m_callTree->setUpdatesEnabled(false);
+    const auto& tree = m_profiler->tree();
+    for (auto child: tree.children(0))
+        addNode(child, nullptr);
+    m_callTree->setUpdatesEnabled(true);
+    m_callTree->resizeColumnToContents(1);
+    m_callTree->resizeColumnToContents(2);
+}
+
+void ProfilerView::addNode(int node, QTreeWidgetItem *parent)
+{
+    const auto& tree = m_profiler->tree();
+    const auto& n = tree.node(node);
+    double total = qMax(1, tree.node(0).count);
+    auto item = parent? new QTreeWidgetItem(parent) : new QTreeWidgetItem(m_callTree);
+    item->setText(0, frameName(n.frame));
+    item->setText(1, QString{"%1%"}.arg(100.0 * n.count / total, 0, 'f', 1));
+    item->setText(2, QString{"%1%"}.arg(100.0 * n.leafCount / total, 0, 'f', 1));
+    item->setTextAlignment(1, Qt::AlignRight);
+    item->setTextAlignment(2, Qt::AlignRight);
+    if (!n.frame.file.isEmpty())
+        item->setText(3, QString{"%1:%2"}.arg(n.frame.file).arg(n.frame.line));
+    item->setData(0, Qt::UserRole, node);
+    for (auto child: tree.children(node))
+        addNode(child, item);
+}
+
+void ProfilerView::activateNode(int node)
+{
+    const auto& frame = m_profiler->tree().node(node).frame;
+    if (!frame.fullpath.isEmpty())
+        emit locationActivated(frame.fullpath, frame.line);
+}
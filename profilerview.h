@@ -0,0 +1,85 @@
+#ifndef PROFILERVIEW_H
+#define PROFILERVIEW_H
+
+#include <QVector>
+#include <QWidget>
+
+class DebugManager;
+class Profiler;
+class QLabel;
+class QSpinBox;
+class QToolButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+class StackTree;
+
+// Icicle style flame graph of a StackTree, outermost frames at the bottom
+class FlameGraph : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ROW_HEIGHT = 16;
+
+    explicit FlameGraph(const StackTree *tree, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+    void setZoom(int node);
+
+signals:
+    void nodeActivated(int node);
+
+protected:
+    virtual void paintEvent(QPaintEvent *e);
+    virtual void mousePressEvent(QMouseEvent *e);
+    virtual void mouseDoubleClickEvent(QMouseEvent *e);
+    virtual bool event(QEvent *e);
+
+private:
+    struct Box {
+        QRectF rect;
+        int node;
+    };
+
+    void layoutNode(int node, double x, double width, int depth);
+    int depthBelow(int node) const;
+    int nodeAt(const QPoint& pos) const;
+
+    const StackTree *m_tree;
+    QVector<Box> m_boxes;
+    int m_zoom = 0;
+};
+
+class ProfilerView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilerView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+    bool isSampling() const;
+
+signals:
+    void locationActivated(const QString& fullpath, int line);
+    void samplingChanged(bool active);
+
+private slots:
+    void updateStatus();
+    void updateCallTree();
+    void activateNode(int node);
+
+private:
+    void addNode(int node, QTreeWidgetItem *parent);
+
+    Profiler *m_profiler;
+    FlameGraph *m_flame;
+    QTreeWidget *m_callTree;
+    QSpinBox *m_depth;
+    QSpinBox *m_budget;
+    QToolButton *m_buttonRun;
+    QLabel *m_status;
+};
+
+#endif // PROFILERVIEW_H
@@ -0,0 +1,257 @@
+#include "registerview.h"
+#include "debugmanager.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QRegularExpression>
+#include <QScrollBar>
+#include <QStandardItemModel>
+#include <QTableView>
+#include <QTimer>
+#include <QVBoxLayout>
+
+RegisterView::RegisterView(QWidget *parent) :
+    QWidget(parent),
+    m_view(new QTableView(this)),
+    m_model(new QStandardItemModel(this)),
+    m_format(new QComboBox(this)),
+    m_filter(new QLineEdit(this)),
+    m_scrollTimer(new QTimer(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    m_filter->setPlaceholderText(tr("Filter registers"));
+    m_format->addItem(tr("Hex"), "x");
+    m_format->addItem(tr("Natural"), "N");
+    m_format->addItem(tr("Decimal"), "d");
+    toolbar->addWidget(m_filter);
+    toolbar->addWidget(m_format);
+    layout->addLayout(toolbar);
+    layout->addWidget(m_view);
+
+    m_model->setHorizontalHeaderLabels({ tr("Register"), tr("Value") });
+    m_view->setModel(m_model);
+    m_view->verticalHeader()->hide();
+    m_view->horizontalHeader()->setStretchLastSection(true);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    // Values are only pulled for rows on screen, refetch once scrolling settles
+    m_scrollTimer->setSingleShot(true);
+    m_scrollTimer->setInterval(50);
+    connect(m_scrollTimer, &QTimer::timeout, this, &RegisterView::fetchVisible);
+    connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged,
+            m_scrollTimer, QOverload<>::of(&QTimer::start));
+    connect(m_filter, &QLineEdit::textChanged, this, &RegisterView::applyFilter);
+    connect(m_format, QOverload<int>::of(&QComboBox::currentIndexChanged), [this]() {
+        for (int reg = 0; reg < m_rowOf.size(); reg++)
+            if (m_rowOf.at(reg) != -1)
+                m_stale.insert(reg);
+        fetchVisible();
+    });
+}
+
+void RegisterView::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    clear();
+    if (!g)
+        return;
+    connect(g, &DebugManager::asyncStopped, this, &RegisterView::targetStopped);
+    connect(g, &DebugManager::started, this, &RegisterView::clear);
+    connect(g, &DebugManager::terminated, this, &RegisterView::clear);
+}
+
+void RegisterView::clear()
+{
+    m_model->removeRows(0, m_model->rowCount());
+    m_rowOf.clear();
+    m_regOf.clear();
+    m_stale.clear();
+    m_changed.clear();
+    m_pending.clear();
+    m_namesRequested = false;
+    m_generation++;
+    m_thread = -1;
+    m_level = -1;
+}
+
+void RegisterView::targetStopped()
+{
+    m_generation++;
+    // Values on screen may come from an outer frame, changes are reported
+    // against the innermost one
+    if (m_level > 0)
+        for (int reg = 0; reg < m_rowOf.size(); reg++)
+            if (m_rowOf.at(reg) != -1)
+                m_stale.insert(reg);
+    // gdb selects the innermost frame of the stopped thread
+    m_thread = -1;
+    m_level = -1;
+    if (m_rowOf.isEmpty())
+        loadNames();
+    else
+        updateChanged();
+}
+
+void RegisterView::frameSelected(int thread, int level)
+{
+    if (thread == m_thread && level == m_level)
+        return;
+    m_thread = thread;
+    m_level = level;
+    // Replies for the previous frame must not land in this one
+    m_generation++;
+    for (int reg = 0; reg < m_rowOf.size(); reg++)
+        if (m_rowOf.at(reg) != -1)
+            m_stale.insert(reg);
+    fetchVisible();
+}
+
+void RegisterView::loadNames()
+{
+    if (m_namesRequested || !m_debug)
+        return;
+    m_namesRequested = true;
+    m_debug->enqueue("-data-list-register-names", DebugManager::Priority_t::Refresh, [this](const QVariant& r) {
+        auto names = r.toMap().value("register-names").toList();
+        m_model->removeRows(0, m_model->rowCount());
+        m_rowOf.fill(-1, names.size());
+        m_regOf.clear();
+        for (int reg = 0; reg < names.size(); reg++) {
+            auto name = names.at(reg).toString();
+            // Unnamed numbers are holes in the target description
+            if (name.isEmpty())
+                continue;
+            m_rowOf[reg] = m_model->rowCount();
+            m_regOf.append(reg);
+            m_model->appendRow({ new QStandardItem{name}, new QStandardItem });
+            m_stale.insert(reg);
+        }
+        m_view->resizeColumnToContents(0);
+        applyFilter(m_filter->text());
+        // Prime gdb's snapshot so next stop only reports real changes
+        m_debug->enqueue("-data-list-changed-registers", DebugManager::Priority_t::Refresh);
+        fetchVisible();
+    });
+}
+
+void RegisterView::updateChanged()
+{
+    m_debug->enqueue("-data-list-changed-registers", DebugManager::Priority_t::Refresh, [this](const QVariant& r) {
+        for (auto reg: m_changed) {
+            auto item = m_model->item(m_rowOf.value(reg, -1), 1);
+            if (item)
+                item->setForeground(palette().text());
+        }
+        m_changed.clear();
+        for (const auto& e: r.toMap().value("changed-registers").toList()) {
+            int reg = e.toInt();
+            if (m_rowOf.value(reg, -1) == -1)
+                continue;
+            m_changed.insert(reg);
+            m_stale.insert(reg);
+        }
+        fetchVisible();
+    });
+}
+
+void RegisterView::fetchVisible()
+{
+    if (!m_debug || m_debug->isInferiorRunning())
+        return;
+    QList<int> regs;
+    for (auto reg: visibleRegisters())
+        if (m_stale.contains(reg) && !m_pending.contains(reg))
+            regs.append(reg);
+    if (!regs.isEmpty())
+        fetchValues(regs);
+}
+
+void RegisterView::fetchValues(const QList<int> &regs)
+{
+    QStringList numbers;
+    for (auto reg: regs) {
+        numbers.append(QString::number(reg));
+        m_pending.insert(reg);
+    }
+    int generation = m_generation;
+    auto cmd = QString{"-data-list-register-values"};
+    // --frame needs --thread, without a known thread gdb's selection applies
+    if (m_thread > 0 && m_level != -1)
+        cmd += QString{" --thread %1 --frame %2"}.arg(m_thread).arg(m_level);
+    cmd += QString{" --skip-unavailable %1 %2"}.arg(m_format->currentData().toString(), numbers.join(' '));
+    m_debug->enqueue(cmd, DebugManager::Priority_t::Refresh, [this, regs, generation](const QVariant& r) {
+        for (auto reg: regs)
+            m_pending.remove(reg);
+        if (generation != m_generation) {
+            fetchVisible();
+            return;
+        }
+        for (const auto& e: r.toMap().value("register-values").toList()) {
+            auto m = e.toMap();
+            int reg = m.value("number").toInt();
+            auto item = m_model->item(m_rowOf.value(reg, -1), 1);
+            if (!item)
+                continue;
+            item->setText(m.value("value").toString());
+            item->setForeground(m_changed.contains(reg)? QBrush{Qt::red} : palette().text());
+            m_stale.remove(reg);
+        }
+        // Skipped as unavailable, e.g. not saved in an outer frame
+        for (auto reg: regs)
+            if (m_stale.contains(reg))
+                markUnavailable(reg);
+    }, [this, regs, generation](const QVariant& r) {
+        for (auto reg: regs)
+            m_pending.remove(reg);
+        // Still stale, asked again on the next stop or frame change
+        if (generation != m_generation || DebugManager::isCancelled(r))
+            return;
+        for (auto reg: regs)
+            markUnavailable(reg);
+    });
+}
+
+void RegisterView::markUnavailable(int reg)
+{
+    // An old value would pass for the current one
+    m_stale.remove(reg);
+    auto item = m_model->item(m_rowOf.value(reg, -1), 1);
+    if (!item)
+        return;
+    item->setText(tr("<unavailable>"));
+    item->setForeground(palette().color(QPalette::Disabled, QPalette::Text));
+}
+
+QList<int> RegisterView::visibleRegisters() const
+{
+    QList<int> regs;
+    int first = m_view->rowAt(0);
+    int last = m_view->rowAt(m_view->viewport()->height() - 1);
+    if (first < 0)
+        return regs;
+    if (last < 0)
+        last = m_model->rowCount() - 1;
+    for (int row = first; row <= last; row++)
+        if (!m_view->isRowHidden(row))
+            regs.append(m_regOf.at(row));
+    return regs;
+}
+
+void RegisterView::applyFilter(const QString &text)
+{
+    QRegularExpression re{text, QRegularExpression::CaseInsensitiveOption};
+    for (int row = 0; row < m_model->rowCount(); row++) {
+        auto name = m_model->item(row, 0)->text();
+        m_view->setRowHidden(row, !text.isEmpty() && !re.match(name).hasMatch());
+    }
+    m_scrollTimer->start();
+}
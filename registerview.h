@@ -0,0 +1,59 @@
+#ifndef REGISTERVIEW_H
+#define REGISTERVIEW_H
+
+#include <QSet>
+#include <QVector>
+#include <QWidget>
+
+class DebugManager;
+class QComboBox;
+class QLineEdit;
+class QStandardItemModel;
+class QTableView;
+class QTimer;
+
+class RegisterView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RegisterView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    void clear();
+    void targetStopped();
+    // Values of an outer frame, as unwound by gdb
+    void frameSelected(int thread, int level);
+
+private slots:
+    void fetchVisible();
+    void applyFilter(const QString& text);
+
+private:
+    void loadNames();
+    void updateChanged();
+    void fetchValues(const QList<int>& regs);
+    void markUnavailable(int reg);
+    QList<int> visibleRegisters() const;
+
+    DebugManager *m_debug = nullptr;
+    QTableView *m_view;
+    QStandardItemModel *m_model;
+    QComboBox *m_format;
+    QLineEdit *m_filter;
+    QTimer *m_scrollTimer;
+    QVector<int> m_rowOf;       // register number -> row, -1 if unnamed
+    QVector<int> m_regOf;       // row -> register number
+    QSet<int> m_stale;
+    QSet<int> m_changed;
+    QSet<int> m_pending;
+    bool m_namesRequested = false;
+    int m_generation = 0;
+    // Frame the values are read in, -1 for gdb's selected one
+    int m_thread = -1;
+    int m_level = -1;
+};
+
+#endif // REGISTERVIEW_H
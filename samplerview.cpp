@@ -0,0 +1,182 @@
+#include "samplerview.h"
+#include "livesampler.h"
+#include "debugmanager.h"
+
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPainter>
+#include <QPainterPath>
+#include <QSpinBox>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+namespace conf {
+namespace plot {
+
+const QColor COLORS[] = {
+    QColor("#1f77b4"), QColor("#ff7f0e"), QColor("#2ca02c"), QColor("#d62728"),
+    QColor("#9467bd"), QColor("#8c564b"), QColor("#e377c2"), QColor("#7f7f7f"),
+};
+constexpr int COLOR_COUNT = sizeof(COLORS) / sizeof(COLORS[0]);
+
+}
+}
+
+SamplePlot::SamplePlot(LiveSampler *sampler, QWidget *parent) :
+    QWidget(parent), m_sampler(sampler)
+{
+    setMinimumHeight(80);
+    setAutoFillBackground(true);
+    setBackgroundRole(QPalette::Base);
+}
+
+void SamplePlot::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+    const auto& channels = m_sampler->channels();
+    double tEnd = 0;
+    for (const auto& c: channels)
+        if (c.ring.size() > 0)
+            tEnd = qMax(tEnd, c.ring.at(c.ring.size() - 1).x());
+    double tStart = tEnd - LiveSampler::WINDOW_SECONDS;
+    auto fm = fontMetrics();
+    int legendY = fm.ascent();
+    // Every channel gets its own vertical scale, they rarely share units
+    for (int i = 0; i < channels.size(); i++) {
+        const auto& ring = channels.at(i).ring;
+        auto color = conf::plot::COLORS[i % conf::plot::COLOR_COUNT];
+        if (ring.size() == 0)
+            continue;
+        double lo = ring.at(0).y();
+        double hi = lo;
+        for (int k = 1; k < ring.size(); k++) {
+            lo = qMin(lo, ring.at(k).y());
+            hi = qMax(hi, ring.at(k).y());
+        }
+        double span = (hi - lo) > 0? (hi - lo) : 1.0;
+        QPainterPath path;
+        for (int k = 0; k < ring.size(); k++) {
+            auto pt = ring.at(k);
+            QPointF xy{(pt.x() - tStart) / LiveSampler::WINDOW_SECONDS * width(),
+                       height() - 2 - (pt.y() - lo) / span * (height() - 4)};
+            if (k == 0)
+                path.moveTo(xy);
+            else
+                path.lineTo(xy);
+        }
+        p.setPen(QPen{color, 1.5});
+        p.drawPath(path);
+        auto last = ring.at(ring.size() - 1).y();
+        p.drawText(4, legendY, QString{"%1 = %2"}.arg(channels.at(i).expr).arg(last));
+        legendY += fm.height();
+    }
+}
+
+SamplerView::SamplerView(QWidget *parent) :
+    QWidget(parent),
+    m_sampler(new LiveSampler(this)),
+    m_plot(new SamplePlot(m_sampler, this)),
+    m_expr(new QLineEdit(this)),
+    m_list(new QListWidget(this)),
+    m_rate(new QDoubleSpinBox(this)),
+    m_bandwidth(new QSpinBox(this)),
+    m_buttonRun(new QToolButton(this)),
+    m_status(new QLabel(this))
+{
+    auto layout = new QHBoxLayout(this);
+    auto side = new QVBoxLayout;
+    auto exprLayout = new QHBoxLayout;
+    auto buttonAdd = new QToolButton(this);
+    auto buttonDel = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    side->setSpacing(1);
+    exprLayout->setSpacing(1);
+
+    m_expr->setPlaceholderText(tr("Expression"));
+    buttonAdd->setIcon(QIcon{":/images/list-add.svg"});
+    buttonDel->setIcon(QIcon{":/images/list-remove.svg"});
+    m_rate->setRange(0.1, 1000);
+    m_rate->setValue(m_sampler->rate());
+    m_rate->setSuffix(tr(" Hz"));
+    m_bandwidth->setRange(64, 1 << 24);
+    m_bandwidth->setValue(m_sampler->bandwidthLimit());
+    m_bandwidth->setSuffix(tr(" B/s"));
+    m_bandwidth->setToolTip(tr("Maximum link bandwidth used by sampling"));
+    m_buttonRun->setIcon(QIcon{":/images/debug-run-v2.svg"});
+    m_buttonRun->setToolTip(tr("Start/stop sampling"));
+
+    exprLayout->addWidget(m_expr);
+    exprLayout->addWidget(buttonAdd);
+    exprLayout->addWidget(buttonDel);
+    side->addLayout(exprLayout);
+    side->addWidget(m_list);
+    side->addWidget(m_rate);
+    side->addWidget(m_bandwidth);
+    side->addWidget(m_buttonRun);
+    side->addWidget(m_status);
+    layout->addLayout(side, 0);
+    layout->addWidget(m_plot, 1);
+
+    connect(buttonAdd, &QToolButton::clicked, [this]() {
+        addExpression(m_expr->text());
+        m_expr->clear();
+    });
+    connect(m_expr, &QLineEdit::returnPressed, [this]() {
+        addExpression(m_expr->text());
+        m_expr->clear();
+    });
+    connect(buttonDel, &QToolButton::clicked, [this]() {
+        for (auto item: m_list->selectedItems())
+            m_sampler->removeExpression(item->text());
+    });
+    connect(m_buttonRun, &QToolButton::clicked, [this]() {
+        if (m_sampler->isActive())
+            m_sampler->stop();
+        else
+            m_sampler->start();
+    });
+    connect(m_rate, QOverload<double>::of(&QDoubleSpinBox::valueChanged), m_sampler, &LiveSampler::setRate);
+    connect(m_bandwidth, QOverload<int>::of(&QSpinBox::valueChanged), m_sampler, &LiveSampler::setBandwidthLimit);
+    connect(m_rate, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &SamplerView::updateStatus);
+    connect(m_bandwidth, QOverload<int>::of(&QSpinBox::valueChanged), this, &SamplerView::updateStatus);
+    connect(m_sampler, &LiveSampler::channelsChanged, this, &SamplerView::updateChannels);
+    connect(m_sampler, &LiveSampler::channelsChanged, this, &SamplerView::updateStatus);
+    connect(m_sampler, &LiveSampler::sampled, m_plot, QOverload<>::of(&QWidget::update));
+    connect(m_sampler, &LiveSampler::error, m_status, &QLabel::setText);
+    connect(m_sampler, &LiveSampler::activeChanged, [this](bool active) {
+        m_buttonRun->setIcon(QIcon{active? ":/images/debug-pause-v2.svg" : ":/images/debug-run-v2.svg"});
+        updateStatus();
+    });
+}
+
+void SamplerView::setDebugManager(DebugManager *g)
+{
+    m_sampler->setDebugManager(g);
+}
+
+void SamplerView::addExpression(const QString &expr)
+{
+    m_sampler->addExpression(expr.trimmed());
+}
+
+void SamplerView::updateChannels()
+{
+    m_list->clear();
+    for (const auto& c: m_sampler->channels()) {
+        auto item = new QListWidgetItem{c.expr, m_list};
+        item->setToolTip(c.resolved? tr("0x%1, %2 bytes").arg(c.addr, 0, 16).arg(c.size) : tr("unresolved"));
+    }
+    m_plot->update();
+}
+
+void SamplerView::updateStatus()
+{
+    m_status->setText(m_sampler->isActive()?
+                          tr("%1 samples/s").arg(m_sampler->effectiveRate(), 0, 'f', 1) :
+                          tr("stopped"));
+}
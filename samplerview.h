@@ -0,0 +1,54 @@
+#ifndef SAMPLERVIEW_H
+#define SAMPLERVIEW_H
+
+#include <QWidget>
+
+class DebugManager;
+class LiveSampler;
+class QDoubleSpinBox;
+class QLabel;
+class QLineEdit;
+class QListWidget;
+class QSpinBox;
+class QToolButton;
+
+class SamplePlot : public QWidget
+{
+public:
+    explicit SamplePlot(LiveSampler *sampler, QWidget *parent = nullptr);
+
+protected:
+    virtual void paintEvent(QPaintEvent *e);
+
+private:
+    LiveSampler *m_sampler;
+};
+
+class SamplerView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SamplerView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+public slots:
+    void addExpression(const QString& expr);
+
+private slots:
+    void updateChannels();
+    void updateStatus();
+
+private:
+    LiveSampler *m_sampler;
+    SamplePlot *m_plot;
+    QLineEdit *m_expr;
+    QListWidget *m_list;
+    QDoubleSpinBox *m_rate;
+    QSpinBox *m_bandwidth;
+    QToolButton *m_buttonRun;
+    QLabel *m_status;
+};
+
+#endif // SAMPLERVIEW_H
@@ -0,0 +1,81 @@
+#include "schedulerview.h"
+#include "debugmanager.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace conf {
+namespace scheduler {
+
+constexpr int REFRESH_INTERVAL = 250;
+
+}
+}
+
+SchedulerView::SchedulerView(QWidget *parent) :
+    QWidget(parent),
+    m_table(new QTableWidget(DebugManager::PRIORITY_COUNT, 5, this)),
+    m_inFlight(new QLabel(this)),
+    m_timer(new QTimer(this))
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    layout->addWidget(m_table);
+    layout->addWidget(m_inFlight);
+
+    m_table->setHorizontalHeaderLabels({ tr("Queued"), tr("Sent"), tr("Dropped"),
+                                         tr("Avg wait"), tr("Max wait") });
+    m_table->setVerticalHeaderLabels({ tr("Interactive"), tr("Refresh"), tr("Background") });
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int row = 0; row < m_table->rowCount(); row++)
+        for (int col = 0; col < m_table->columnCount(); col++) {
+            auto item = new QTableWidgetItem;
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_table->setItem(row, col, item);
+        }
+
+    m_timer->setInterval(conf::scheduler::REFRESH_INTERVAL);
+    connect(m_timer, &QTimer::timeout, this, &SchedulerView::refresh);
+}
+
+void SchedulerView::setDebugManager(DebugManager *g)
+{
+    m_debug = g;
+    refresh();
+}
+
+void SchedulerView::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+    refresh();
+    m_timer->start();
+}
+
+void SchedulerView::hideEvent(QHideEvent *e)
+{
+    QWidget::hideEvent(e);
+    m_timer->stop();
+}
+
+void SchedulerView::refresh()
+{
+    if (!m_debug)
+        return;
+    for (int row = 0; row < DebugManager::PRIORITY_COUNT; row++) {
+        auto s = m_debug->queueStats(DebugManager::Priority_t(row));
+        auto avg = s.sent? double(s.totalWaitMs) / s.sent : 0.0;
+        m_table->item(row, 0)->setText(QString::number(s.depth));
+        m_table->item(row, 1)->setText(QString::number(s.sent));
+        m_table->item(row, 2)->setText(QString::number(s.dropped));
+        m_table->item(row, 3)->setText(tr("%1 ms").arg(avg, 0, 'f', 1));
+        m_table->item(row, 4)->setText(tr("%1 ms").arg(s.maxWaitMs));
+    }
+    m_inFlight->setText(tr("In flight: %1 of %2")
+                        .arg(m_debug->commandsInFlight())
+                        .arg(DebugManager::MAX_IN_FLIGHT));
+}
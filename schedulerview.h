@@ -0,0 +1,34 @@
+#ifndef SCHEDULERVIEW_H
+#define SCHEDULERVIEW_H
+
+#include <QWidget>
+
+class DebugManager;
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+class SchedulerView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SchedulerView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+protected:
+    virtual void showEvent(QShowEvent *e);
+    virtual void hideEvent(QHideEvent *e);
+
+private slots:
+    void refresh();
+
+private:
+    DebugManager *m_debug = nullptr;
+    QTableWidget *m_table;
+    QLabel *m_inFlight;
+    QTimer *m_timer;
+};
+
+#endif // SCHEDULERVIEW_H
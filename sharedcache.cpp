@@ -0,0 +1,110 @@
+#include "sharedcache.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+constexpr int SharedCache::MAX_INTERNED;
+constexpr qint64 SharedCache::MAX_SOURCE_BYTES;
+
+static qint64 textBytes(const QString& text)
+{
+    return qint64(text.size()) * qint64(sizeof(QChar));
+}
+
+SharedCache *SharedCache::instance()
+{
+    static SharedCache *self = nullptr;
+    if (!self)
+        self = new SharedCache;
+    return self;
+}
+
+QString SharedCache::sourceText(const QString &path, bool *ok)
+{
+    QString text;
+    if (cachedSourceText(path, &text)) {
+        if (ok)
+            *ok = true;
+        return text;
+    }
+    QFileInfo info{path};
+    QFile f{path};
+    if (!f.open(QFile::ReadOnly)) {
+        removeSource(path);
+        if (ok)
+            *ok = false;
+        return {};
+    }
+    text = QString::fromUtf8(f.readAll());
+    insertSource(path, info.lastModified(), info.size(), text);
+    if (ok)
+        *ok = true;
+    return text;
+}
+
+bool SharedCache::cachedSourceText(const QString &path, QString *text)
+{
+    auto it = m_sources.find(path);
+    if (it == m_sources.end())
+        return false;
+    QFileInfo info{path};
+    if (it->modified != info.lastModified() || it->size != info.size())
+        return false;
+    it->lastUse = ++m_useCounter;
+    *text = it->text;
+    return true;
+}
+
+void SharedCache::setSourceText(const QString &path, const QDateTime &modified, qint64 size, const QString &text)
+{
+    insertSource(path, modified, size, text);
+}
+
+void SharedCache::insertSource(const QString &path, const QDateTime &modified, qint64 size, const QString &text)
+{
+    removeSource(path);
+    m_sources.insert(path, { modified, size, text, ++m_useCounter });
+    m_sourceBytes += textBytes(text);
+    // Few files are open at once, a scan for the oldest is cheap enough; the
+    // newest one stays even if it alone exceeds the budget
+    while (m_sourceBytes > MAX_SOURCE_BYTES && m_sources.size() > 1) {
+        auto oldest = m_sources.cbegin();
+        for (auto it = m_sources.cbegin(); it != m_sources.cend(); ++it)
+            if (it->lastUse < oldest->lastUse)
+                oldest = it;
+        auto key = oldest.key();
+        removeSource(key);
+    }
+}
+
+void SharedCache::removeSource(const QString &path)
+{
+    auto it = m_sources.find(path);
+    if (it == m_sources.end())
+        return;
+    m_sourceBytes -= textBytes(it->text);
+    m_sources.erase(it);
+}
+
+QString SharedCache::intern(const QString &s)
+{
+    auto it = m_interned.constFind(s);
+    if (it != m_interned.cend())
+        return *it;
+    if (m_interned.size() < MAX_INTERNED)
+        m_interned.insert(s);
+    return s;
+}
+
+QVariant SharedCache::metadata(const QString &kind, const QString &path) const
+{
+    auto it = m_metadata.constFind(kind + ':' + path);
+    if (it == m_metadata.cend() || it->modified != QFileInfo{path}.lastModified())
+        return {};
+    return it->value;
+}
+
+void SharedCache::setMetadata(const QString &kind, const QString &path, const QVariant &value)
+{
+    m_metadata.insert(kind + ':' + path, { QFileInfo{path}.lastModified(), value });
+}
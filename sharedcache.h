@@ -0,0 +1,64 @@
+#ifndef SHAREDCACHE_H
+#define SHAREDCACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+// Process wide data that every debug session can reuse: source text, strings
+// that repeat across MI records and metadata derived from executables.
+class SharedCache
+{
+public:
+    static constexpr int MAX_INTERNED = 1 << 16;
+    // Least recently used sources are dropped past this many bytes of text
+    static constexpr qint64 MAX_SOURCE_BYTES = 64 << 20;
+
+    static SharedCache *instance();
+
+    // Contents of path, read again only when size or mtime change on disk
+    QString sourceText(const QString& path, bool *ok = nullptr);
+    // Same check without reading the file, for callers loading it elsewhere
+    bool cachedSourceText(const QString& path, QString *text);
+    void setSourceText(const QString& path, const QDateTime& modified, qint64 size, const QString& text);
+
+    // Returns a copy sharing its data with every equal interned string
+    QString intern(const QString& s);
+
+    // Values derived from a file (source lists of an executable...), dropped
+    // when the file is modified
+    QVariant metadata(const QString& kind, const QString& path) const;
+    void setMetadata(const QString& kind, const QString& path, const QVariant& value);
+
+    int sourceCount() const { return m_sources.size(); }
+    qint64 sourceBytes() const { return m_sourceBytes; }
+    int internedCount() const { return m_interned.size(); }
+
+private:
+    SharedCache() = default;
+
+    struct Source {
+        QDateTime modified;
+        qint64 size;
+        QString text;
+        quint64 lastUse;
+    };
+
+    struct Metadata {
+        QDateTime modified;
+        QVariant value;
+    };
+
+    void insertSource(const QString& path, const QDateTime& modified, qint64 size, const QString& text);
+    void removeSource(const QString& path);
+
+    QHash<QString, Source> m_sources;
+    qint64 m_sourceBytes = 0;
+    quint64 m_useCounter = 0;
+    QSet<QString> m_interned;
+    QHash<QString, Metadata> m_metadata;
+};
+
+#endif // SHAREDCACHE_H
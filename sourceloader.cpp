@@ -0,0 +1,154 @@
+#include "sourceloader.h"
+#include "perfstats.h"
+#include "sharedcache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <Qsci/qsciscintilla.h>
+
+constexpr int SourceLoader::CHUNK_SIZE;
+
+SourceLoader::SourceLoader(QsciScintilla *editor, QObject *parent) :
+    QObject(parent),
+    m_editor(editor),
+    m_watcher(new QFutureWatcher<File>(this)),
+    m_idle(new QTimer(this))
+{
+    m_idle->setInterval(0);
+    connect(m_watcher, &QFutureWatcher<File>::finished, this, &SourceLoader::fileRead);
+    connect(m_idle, &QTimer::timeout, this, &SourceLoader::appendChunk);
+}
+
+bool SourceLoader::open(const QString &path, int line)
+{
+    m_line = qMax(1, line);
+    if (path == m_path && m_watcher->isRunning())
+        return false;
+    QString text;
+    bool cached = SharedCache::instance()->cachedSourceText(path, &text);
+    if (path == m_path && (cached || m_idle->isActive())) {
+        // The text is in memory already, at most the insertion is pending
+        appendThrough(m_line);
+        return true;
+    }
+    m_idle->stop();
+    m_path = path;
+    if (cached) {
+        start(text);
+        return true;
+    }
+    // Replacing the future drops the result of a file that is no longer wanted
+    m_watcher->setFuture(QtConcurrent::run(&SourceLoader::readFile, path));
+    return false;
+}
+
+bool SourceLoader::isLoading() const
+{
+    return m_watcher->isRunning() || m_idle->isActive();
+}
+
+void SourceLoader::clear()
+{
+    m_idle->stop();
+    m_path.clear();
+    m_utf8.clear();
+    m_offset = 0;
+    m_lineCount = 0;
+    bool readOnly = m_editor->isReadOnly();
+    m_editor->setReadOnly(false);
+    m_editor->clear();
+    m_editor->setReadOnly(readOnly);
+    m_editor->setWindowFilePath({});
+}
+
+SourceLoader::File SourceLoader::readFile(const QString &path)
+{
+    QFileInfo info{path};
+    QFile f{path};
+    if (!f.open(QFile::ReadOnly))
+        return { path, false, {}, 0, {} };
+    return { path, true, info.lastModified(), info.size(), QString::fromUtf8(f.readAll()) };
+}
+
+void SourceLoader::fileRead()
+{
+    auto file = m_watcher->result();
+    if (file.path != m_path)
+        return;
+    if (!file.ok) {
+        m_path.clear();
+        emit failed(file.path);
+        return;
+    }
+    SharedCache::instance()->setSourceText(file.path, file.modified, file.size, file.text);
+    start(file.text);
+    emit ready(file.path);
+    if (!m_idle->isActive())
+        emit finished(file.path);
+}
+
+void SourceLoader::start(const QString &text)
+{
+    PERF_SCOPE("SourceLoader::start");
+    m_utf8 = text.toUtf8();
+    m_offset = 0;
+    m_lineCount = m_utf8.count('\n') + 1;
+    bool readOnly = m_editor->isReadOnly();
+    m_editor->setReadOnly(false);
+    m_editor->SendScintilla(QsciScintilla::SCI_SETUNDOCOLLECTION, false);
+    m_editor->clear();
+    m_editor->setReadOnly(readOnly);
+    m_editor->setWindowFilePath(m_path);
+    appendThrough(m_line);
+    if (m_offset < m_utf8.size())
+        m_idle->start();
+}
+
+void SourceLoader::appendThrough(int line)
+{
+    // Also fill the screen below the requested line
+    int wanted = line + m_editor->linesOnScreen();
+    int end = m_offset;
+    int lines = m_editor->lines();
+    while (end < m_utf8.size() && lines < wanted) {
+        int nl = m_utf8.indexOf('\n', end);
+        end = nl == -1? m_utf8.size() : nl + 1;
+        lines++;
+    }
+    append(end);
+}
+
+void SourceLoader::appendChunk()
+{
+    PERF_SCOPE("SourceLoader::appendChunk");
+    int end = m_offset + CHUNK_SIZE;
+    if (end < m_utf8.size()) {
+        // Never split a line, nor a multi byte character
+        int nl = m_utf8.indexOf('\n', end);
+        end = nl == -1? m_utf8.size() : nl + 1;
+    }
+    append(qMin(end, m_utf8.size()));
+    if (m_offset >= m_utf8.size()) {
+        m_idle->stop();
+        emit finished(m_path);
+    }
+}
+
+void SourceLoader::append(int end)
+{
+    if (end <= m_offset)
+        return;
+    bool readOnly = m_editor->isReadOnly();
+    m_editor->setReadOnly(false);
+    m_editor->SendScintilla(QsciScintilla::SCI_APPENDTEXT, end - m_offset, m_utf8.constData() + m_offset);
+    m_editor->setReadOnly(readOnly);
+    m_offset = end;
+    if (m_offset >= m_utf8.size()) {
+        m_utf8.clear();
+        m_offset = 0;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SOURCELOADER_H
+#define SOURCELOADER_H
+
+#include <QDateTime>
+#include <QObject>
+
+class QsciScintilla;
+class QTimer;
+template <typename T> class QFutureWatcher;
+
+// Fills the source editor without blocking the GUI thread: the file is read on
+// a worker, everything up to the requested line is inserted at once so that
+// line shows up whatever the file size, and the rest follows in idle chunks.
+class SourceLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Bytes inserted per idle step once the requested line is shown
+    static constexpr int CHUNK_SIZE = 256 * 1024;
+
+    explicit SourceLoader(QsciScintilla *editor, QObject *parent = nullptr);
+
+    // Returns true when line (1-based) of path is in the editor already,
+    // otherwise ready() follows once it is
+    bool open(const QString& path, int line = 1);
+
+    const QString& path() const { return m_path; }
+    // Lines of the whole file, including the ones not inserted yet
+    int lineCount() const { return m_lineCount; }
+    bool isLoading() const;
+
+public slots:
+    // Empties the editor and forgets the file, the next open() reads it again
+    void clear();
+
+signals:
+    void ready(const QString& path);
+    void finished(const QString& path);
+    void failed(const QString& path);
+
+private slots:
+    void fileRead();
+    void appendChunk();
+
+private:
+    struct File {
+        QString path;
+        bool ok;
+        QDateTime modified;
+        qint64 size;
+        QString text;
+    };
+
+    static File readFile(const QString& path);
+    void start(const QString& text);
+    void appendThrough(int line);
+    void append(int end);
+
+    QsciScintilla *m_editor;
+    QFutureWatcher<File> *m_watcher;
+    QTimer *m_idle;
+    QString m_path;
+    QByteArray m_utf8;
+    int m_offset = 0;
+    int m_line = 1;
+    int m_lineCount = 0;
+};
+
+#endif // SOURCELOADER_H
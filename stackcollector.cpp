@@ -0,0 +1,210 @@
+#include "stackcollector.h"
+#include "perfstats.h"
+
+#include <algorithm>
+
+constexpr int StackCollector::MAX_PENDING;
+constexpr quint64 StackTree::TRUNCATED;
+constexpr quint64 StackTree::FUNCTION_KEY;
+
+StackCollector::StackCollector(QObject *parent) : QObject(parent)
+{
+}
+
+void StackCollector::setDebugManager(DebugManager *g)
+{
+    cancel();
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    if (!g)
+        return;
+    // Queued background requests are dropped once the inferior moves on
+    connect(g, &DebugManager::asyncRunning, this, &StackCollector::cancel);
+    connect(g, &DebugManager::terminated, this, &StackCollector::cancel);
+}
+
+void StackCollector::collect(int depth)
+{
+    cancel();
+    if (!m_debug || !m_debug->isGdbExecuting() || m_debug->isInferiorRunning()) {
+        emit failed(tr("The inferior must be stopped"));
+        return;
+    }
+    m_generation = m_debug->stopGeneration();
+    m_depth = depth;
+    int generation = m_generation;
+    m_pending.insert(0, m_debug->enqueue("-thread-list-ids", DebugManager::Priority_t::Background,
+                                         [this, generation](const QVariant& r) {
+        m_pending.remove(0);
+        if (generation != m_generation)
+            return;
+        for (const auto& id: r.toMap().value("thread-ids").toMap().values("thread-id"))
+            m_threads.enqueue(id.toInt());
+        // values() hands out the most recent key first
+        std::sort(m_threads.begin(), m_threads.end());
+        m_total = m_threads.size();
+        m_done = 0;
+        if (m_threads.isEmpty()) {
+            m_generation = -1;
+            emit collected({});
+            return;
+        }
+        for (int i = 0; i < MAX_PENDING; i++)
+            sendNext();
+    }, [this, generation](const QVariant& r) {
+        m_pending.remove(0);
+        if (generation != m_generation)
+            return;
+        m_generation = -1;
+        emit failed(r.toMap().value("msg").toString());
+    }));
+}
+
+void StackCollector::cancel()
+{
+    if (m_debug)
+        for (auto token: m_pending)
+            m_debug->cancel(token);
+    m_pending.clear();
+    m_threads.clear();
+    m_stacks.clear();
+    m_generation = -1;
+}
+
+void StackCollector::sendNext()
+{
+    if (m_threads.isEmpty())
+        return;
+    int thread = m_threads.dequeue();
+    auto cmd = QString{"-stack-list-frames --thread %1 --no-frame-filters"}.arg(thread);
+    // One frame more than asked tells whether the stack was cut
+    if (m_depth > 0)
+        cmd += QString{" 0 %1"}.arg(m_depth);
+    int generation = m_generation;
+    // Stacks of other threads must not replace the one in the stack view
+    auto token = m_debug->enqueue(cmd, DebugManager::Priority_t::Background,
+                                  [this, thread, generation](const QVariant& r) {
+        m_pending.remove(thread);
+        if (generation == m_generation)
+            received(thread, r);
+    }, [this, thread, generation](const QVariant& r) {
+        m_pending.remove(thread);
+        if (generation != m_generation)
+            return;
+        // The target resumed, the stacks collected so far are a torn snapshot
+        if (DebugManager::isCancelled(r)) {
+            m_threads.clear();
+            m_stacks.clear();
+            m_generation = -1;
+            emit failed(r.toMap().value("msg").toString());
+            return;
+        }
+        // The thread exited meanwhile, nothing to show for it
+        finishOne();
+    }, DebugManager::Delivery_t::HandlerOnly);
+    m_pending.insert(thread, token);
+}
+
+void StackCollector::received(int thread, const QVariant &r)
+{
+    PERF_SCOPE("StackCollector::received");
+    ThreadStack stack;
+    stack.thread = thread;
+    stack.truncated = false;
+    auto list = r.toMap().value("stack").toList();
+    if (!list.isEmpty())
+        for (const auto& e: list.first().toMap().values("frame"))
+            stack.frames.append(gdb::Frame::parseMap(e.toMap()));
+    std::sort(stack.frames.begin(), stack.frames.end(), [](const gdb::Frame& a, const gdb::Frame& b) {
+        return a.level < b.level;
+    });
+    if (m_depth > 0 && stack.frames.size() > m_depth) {
+        stack.truncated = true;
+        stack.frames.erase(stack.frames.begin() + m_depth, stack.frames.end());
+    }
+    m_stacks.append(stack);
+    finishOne();
+}
+
+void StackCollector::finishOne()
+{
+    m_done++;
+    emit progress(m_done, m_total);
+    if (m_done < m_total) {
+        sendNext();
+        return;
+    }
+    auto stacks = m_stacks;
+    m_stacks.clear();
+    m_generation = -1;
+    emit collected(stacks);
+}
+
+StackTree::StackTree(Key_t key) : m_key(key)
+{
+    clear();
+}
+
+void StackTree::add(const QList<gdb::Frame> &frames, int thread, bool truncated)
+{
+    int at = 0;
+    m_nodes[0].count++;
+    if (truncated) {
+        gdb::Frame cut;
+        cut.func = QObject::tr("[truncated]");
+        cut.addr = TRUNCATED;
+        cut.line = 0;
+        at = child(at, TRUNCATED, cut);
+        m_nodes[at].count++;
+        if (thread != -1)
+            m_nodes[at].threads.append(thread);
+    }
+    for (int i = frames.size() - 1; i >= 0; i--) {
+        const auto& f = frames.at(i);
+        at = child(at, keyOf(f), f);
+        m_nodes[at].count++;
+        if (thread != -1)
+            m_nodes[at].threads.append(thread);
+    }
+    if (m_nodes.at(at).leafCount++ == 0)
+        m_unique++;
+}
+
+int StackTree::child(int parent, quint64 addr, const gdb::Frame &frame)
+{
+    auto it = m_nodes.at(parent).children.constFind(addr);
+    if (it != m_nodes.at(parent).children.cend())
+        return it.value();
+    int next = m_nodes.size();
+    m_nodes[parent].children.insert(addr, next);
+    m_nodes.append({ addr, frame, parent, 0, 0, {}, {} });
+    return next;
+}
+
+quint64 StackTree::keyOf(const gdb::Frame &frame)
+{
+    if (m_key == ByAddress || frame.func.isEmpty())
+        return frame.addr;
+    auto it = m_functions.constFind(frame.func);
+    if (it != m_functions.cend())
+        return it.value();
+    return m_functions.insert(frame.func, FUNCTION_KEY | quint64(m_functions.size())).value();
+}
+
+void StackTree::clear()
+{
+    m_functions.clear();
+    m_nodes.clear();
+    m_nodes.append({ 0, {}, -1, 0, 0, {}, {} });
+    m_unique = 0;
+}
+
+QList<int> StackTree::children(int i) const
+{
+    auto list = m_nodes.at(i).children.values();
+    std::sort(list.begin(), list.end(), [this](int a, int b) {
+        return m_nodes.at(a).count > m_nodes.at(b).count;
+    });
+    return list;
+}
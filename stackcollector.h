@@ -0,0 +1,109 @@
+#ifndef STACKCOLLECTOR_H
+#define STACKCOLLECTOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QVector>
+
+#include "debugmanager.h"
+
+// Backtraces of every thread of a stopped inferior. One -stack-list-frames
+// --thread N per thread, with a bounded number queued at a time so that user
+// commands still get through while thousands of threads are walked.
+class StackCollector : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_PENDING = 16;
+
+    struct ThreadStack {
+        int thread;
+        // Innermost frame first
+        QList<gdb::Frame> frames;
+        // More frames lie beyond the collect() depth
+        bool truncated;
+    };
+
+    explicit StackCollector(QObject *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+    bool isCollecting() const { return m_generation != -1; }
+
+public slots:
+    // depth 0 walks whole stacks
+    void collect(int depth = 0);
+    void cancel();
+
+signals:
+    void progress(int done, int total);
+    void collected(const QList<StackCollector::ThreadStack>& stacks);
+    void failed(const QString& msg);
+
+private:
+    void sendNext();
+    void received(int thread, const QVariant& r);
+    void finishOne();
+
+    DebugManager *m_debug = nullptr;
+    QQueue<int> m_threads;
+    // thread -> token of its request, 0 for the thread list
+    QHash<int, int> m_pending;
+    QList<ThreadStack> m_stacks;
+    int m_generation = -1;
+    int m_depth = 0;
+    int m_total = 0;
+    int m_done = 0;
+};
+
+// Stacks merged by frame address, outermost frames below the root, so
+// threads waiting in the same place end up on one path with a count.
+// Sampled stacks stop at a different pc almost every time and are merged by
+// function instead. Truncated stacks lack their real outermost frames and
+// hang below a synthetic "[truncated]" node instead of being merged with
+// complete ones.
+class StackTree
+{
+public:
+    static constexpr quint64 TRUNCATED = ~quint64(0);
+    // Set in the keys of functions, frames without a symbol keep their pc
+    static constexpr quint64 FUNCTION_KEY = quint64(1) << 63;
+
+    enum Key_t { ByAddress, ByFunction };
+
+    struct Node {
+        // Merge key, the frame address or a FUNCTION_KEY id
+        quint64 addr;
+        gdb::Frame frame;
+        int parent;
+        int count;
+        // Stacks ending in this very node
+        int leafCount;
+        QList<int> threads;
+        QHash<quint64, int> children;
+    };
+
+    explicit StackTree(Key_t key = ByAddress);
+
+    // frames innermost first, thread -1 when not tracked
+    void add(const QList<gdb::Frame>& frames, int thread = -1, bool truncated = false);
+    void clear();
+
+    int size() const { return m_nodes.size(); }
+    const Node& node(int i) const { return m_nodes.at(i); }
+    // By descending count
+    QList<int> children(int i) const;
+    int uniqueStacks() const { return m_unique; }
+
+private:
+    int child(int parent, quint64 addr, const gdb::Frame& frame);
+    quint64 keyOf(const gdb::Frame& frame);
+
+    Key_t m_key;
+    QVector<Node> m_nodes;
+    QHash<QString, quint64> m_functions;
+    int m_unique = 0;
+};
+
+#endif // STACKCOLLECTOR_H
@@ -0,0 +1,215 @@
+#include "symbolindex.h"
+#include "elfinfo.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+constexpr int SymbolIndex::MAX_RESULTS;
+constexpr quint32 SymbolIndex::FILE_VERSION;
+
+namespace conf {
+namespace symbols {
+
+constexpr quint32 FILE_MAGIC = 0x53594d49; // "SYMI"
+// Two empty strings, the line and the address
+constexpr qint64 MIN_RECORD_SIZE = 4 + 4 + 4 + 8;
+
+}
+}
+
+static quint64 charMask(const QByteArray& s)
+{
+    quint64 m = 0;
+    for (auto c: s) {
+        auto u = uchar(c);
+        if (u >= 'a' && u <= 'z')
+            m |= quint64(1) << (u - 'a');
+        else if (u >= '0' && u <= '9')
+            m |= quint64(1) << (26 + u - '0');
+        else
+            m |= quint64(1) << (36 + u % 28);
+    }
+    return m;
+}
+
+static bool isBoundary(const QByteArray& key, int i)
+{
+    if (i == 0)
+        return true;
+    auto p = key.at(i - 1);
+    return p == '_' || p == ':' || p == '.' || p == ' ' || p == '(';
+}
+
+// -1 when query is not a subsequence of key
+static int score(const QByteArray& key, const QByteArray& query)
+{
+    int s = 0;
+    int k = 0;
+    int last = -2;
+    for (auto c: query) {
+        while (k < key.size() && key.at(k) != c)
+            k++;
+        if (k == key.size())
+            return -1;
+        s += 1;
+        if (isBoundary(key, k))
+            s += 8;
+        if (k == last + 1)
+            s += 4;
+        last = k++;
+    }
+    if (key.startsWith(query))
+        s += 16;
+    // Among equal matches the shorter name is the likelier target
+    return s * 64 - qMin(key.size(), 63);
+}
+
+SymbolIndex SymbolIndex::fromMi(const QVariantMap &symbols)
+{
+    SymbolIndex index;
+    for (const auto& f: symbols.value("debug").toList()) {
+        auto file = f.toMap();
+        auto path = file.value("fullname").toString();
+        if (path.isEmpty())
+            path = file.value("filename").toString();
+        for (const auto& e: file.value("symbols").toList()) {
+            auto sym = e.toMap();
+            index.m_symbols.append({ sym.value("name").toString(), path,
+                                     sym.value("line").toInt(), 0 });
+        }
+    }
+    for (const auto& e: symbols.value("nondebugging").toList()) {
+        auto sym = e.toMap();
+        index.m_symbols.append({ sym.value("name").toString(), {}, 0,
+                                 sym.value("address").toString().toULongLong(nullptr, 16) });
+    }
+    index.finish();
+    return index;
+}
+
+SymbolIndex SymbolIndex::load(const QString &path)
+{
+    SymbolIndex index;
+    QFile f{path};
+    if (!f.open(QFile::ReadOnly))
+        return index;
+    QDataStream in{&f};
+    quint32 magic, version;
+    qint32 count;
+    in >> magic >> version >> count;
+    if (magic != conf::symbols::FILE_MAGIC || version != FILE_VERSION || count < 0)
+        return index;
+    // A corrupt count must not reserve more than the file could hold
+    if (count > (f.size() - f.pos()) / conf::symbols::MIN_RECORD_SIZE)
+        return index;
+    index.m_symbols.reserve(count);
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Symbol s;
+        qint32 line;
+        in >> s.name >> s.file >> line >> s.addr;
+        s.line = line;
+        index.m_symbols.append(s);
+    }
+    if (in.status() != QDataStream::Ok)
+        return {};
+    index.finish();
+    return index;
+}
+
+bool SymbolIndex::save(const QString &path) const
+{
+    QDir{}.mkpath(QFileInfo{path}.absolutePath());
+    QSaveFile f{path};
+    if (!f.open(QFile::WriteOnly))
+        return false;
+    QDataStream out{&f};
+    out << conf::symbols::FILE_MAGIC << FILE_VERSION << qint32(m_symbols.size());
+    for (const auto& s: m_symbols)
+        out << s.name << s.file << qint32(s.line) << s.addr;
+    return f.commit();
+}
+
+QString SymbolIndex::cachePath(const QString &executable)
+{
+    QFileInfo info{executable};
+    auto key = elf::buildId(executable).toHex();
+    if (key.isEmpty()) {
+        // No build-id: path, size and mtime identify the build well enough
+        QCryptographicHash h{QCryptographicHash::Sha1};
+        h.addData(info.absoluteFilePath().toUtf8());
+        h.addData(QByteArray::number(info.size()));
+        h.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+        key = h.result().toHex();
+    }
+    auto dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return QDir{dir}.filePath(QString{"symbols/%1.idx"}.arg(QString::fromLatin1(key)));
+}
+
+void SymbolIndex::finish()
+{
+    std::stable_sort(m_symbols.begin(), m_symbols.end(), [](const Symbol& a, const Symbol& b) {
+        return a.name < b.name;
+    });
+    m_keys.clear();
+    m_masks.clear();
+    m_keys.reserve(m_symbols.size());
+    m_masks.reserve(m_symbols.size());
+    for (const auto& s: m_symbols) {
+        auto key = s.name.toLower().toUtf8();
+        m_masks.append(charMask(key));
+        m_keys.append(key);
+    }
+    m_lastQuery.clear();
+    m_lastMatches.clear();
+}
+
+QVector<int> SymbolIndex::search(const QString &query, int limit)
+{
+    auto q = query.trimmed().toLower().toUtf8();
+    if (q.isEmpty()) {
+        m_lastQuery.clear();
+        m_lastMatches.clear();
+        return {};
+    }
+    bool narrow = !m_lastQuery.isEmpty() && q.startsWith(m_lastQuery);
+    auto mask = charMask(q);
+    QVector<int> matches;
+    QVector<QPair<int, int>> scored;
+    auto consider = [&](int i) {
+        if ((m_masks.at(i) & mask) != mask)
+            return;
+        int s = score(m_keys.at(i), q);
+        if (s < 0)
+            return;
+        matches.append(i);
+        scored.append({ s, i });
+    };
+    if (narrow) {
+        for (auto i: m_lastMatches)
+            consider(i);
+    } else {
+        for (int i = 0; i < m_keys.size(); i++)
+            consider(i);
+    }
+    m_lastQuery = q;
+    m_lastMatches = matches;
+
+    auto byScore = [](const QPair<int, int>& a, const QPair<int, int>& b) {
+        return a.first != b.first? a.first > b.first : a.second < b.second;
+    };
+    int n = qMin(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + n, scored.end(), byScore);
+    QVector<int> result;
+    result.reserve(n);
+    for (int i = 0; i < n; i++)
+        result.append(scored.at(i).second);
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+// Function symbols of one executable with a fuzzy name search. Built from
+// -symbol-info-functions and kept on disk per build-id.
+class SymbolIndex
+{
+public:
+    struct Symbol {
+        QString name;
+        // Empty for symbols without debug information
+        QString file;
+        int line;
+        quint64 addr;
+    };
+
+    static constexpr int MAX_RESULTS = 200;
+    static constexpr quint32 FILE_VERSION = 1;
+
+    static SymbolIndex fromMi(const QVariantMap& symbols);
+    // Empty index when the file is missing or written by another version
+    static SymbolIndex load(const QString& path);
+    bool save(const QString& path) const;
+
+    // Cache file for an executable, keyed by build-id when it has one
+    static QString cachePath(const QString& executable);
+
+    bool isEmpty() const { return m_symbols.isEmpty(); }
+    int size() const { return m_symbols.size(); }
+    const Symbol& at(int i) const { return m_symbols.at(i); }
+
+    // Indices of the best matches, best first. Characters of query must
+    // appear in order; word starts and runs score higher. A query extending
+    // the previous one only rescans the previous matches.
+    QVector<int> search(const QString& query, int limit = MAX_RESULTS);
+
+private:
+    void finish();
+
+    QVector<Symbol> m_symbols;
+    QVector<QByteArray> m_keys;
+    // Characters present in each key, rejects most symbols in one test
+    QVector<quint64> m_masks;
+    QByteArray m_lastQuery;
+    QVector<int> m_lastMatches;
+};
+
+#endif // SYMBOLINDEX_H
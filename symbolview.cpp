@@ -0,0 +1,233 @@
+#include "symbolview.h"
+#include "debugmanager.h"
+#include "perfstats.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QStandardItemModel>
+#include <QTableView>
+#include <QToolButton>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+static SymbolIndex buildAndSave(const QVariantMap& symbols, const QString& path)
+{
+    auto index = SymbolIndex::fromMi(symbols);
+    if (!index.isEmpty())
+        index.save(path);
+    return index;
+}
+
+SymbolView::SymbolView(QWidget *parent) :
+    QWidget(parent),
+    m_query(new QLineEdit(this)),
+    m_view(new QTableView(this)),
+    m_model(new QStandardItemModel(this)),
+    m_status(new QLabel(this))
+{
+    auto layout = new QVBoxLayout(this);
+    auto toolbar = new QHBoxLayout;
+    auto buttonBreak = new QToolButton(this);
+    auto buttonRebuild = new QToolButton(this);
+    layout->setMargin(0);
+    layout->setSpacing(1);
+    toolbar->setSpacing(1);
+    m_query->setPlaceholderText(tr("Search functions"));
+    m_query->setClearButtonEnabled(true);
+    buttonBreak->setIcon(QIcon{":/images/list-add.svg"});
+    buttonBreak->setToolTip(tr("Insert breakpoint at the selected function"));
+    buttonRebuild->setIcon(QIcon{":/images/edit-redo.svg"});
+    buttonRebuild->setToolTip(tr("Rebuild the symbol index"));
+    toolbar->addWidget(m_query);
+    toolbar->addWidget(buttonBreak);
+    toolbar->addWidget(buttonRebuild);
+    layout->addLayout(toolbar);
+    layout->addWidget(m_view);
+    layout->addWidget(m_status);
+
+    m_model->setHorizontalHeaderLabels({ tr("Function"), tr("Location") });
+    m_view->setModel(m_model);
+    m_view->verticalHeader()->hide();
+    m_view->horizontalHeader()->setStretchLastSection(true);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_view->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_view->setWordWrap(false);
+
+    connect(m_query, &QLineEdit::textChanged, this, &SymbolView::search);
+    connect(m_query, &QLineEdit::returnPressed, this, &SymbolView::activate);
+    connect(m_view, &QTableView::activated, this, &SymbolView::activate);
+    connect(buttonBreak, &QToolButton::clicked, this, &SymbolView::insertBreakpoint);
+    connect(buttonRebuild, &QToolButton::clicked, [this]() {
+        if (!m_executable.isEmpty())
+            QFile::remove(SymbolIndex::cachePath(m_executable));
+        rebuild();
+    });
+}
+
+void SymbolView::setDebugManager(DebugManager *g)
+{
+    if (m_debug)
+        disconnect(m_debug, nullptr, this, nullptr);
+    m_debug = g;
+    setIndex({}, {});
+    m_executable.clear();
+    m_retryOnStop = false;
+    m_generation++;
+    if (!g)
+        return;
+    connect(g, &DebugManager::started, this, &SymbolView::rebuild);
+    connect(g, &DebugManager::asyncStopped, this, [this]() {
+        if (m_retryOnStop)
+            rebuild();
+    });
+    connect(g, &DebugManager::terminated, this, [this]() {
+        m_generation++;
+        m_executable.clear();
+        m_retryOnStop = false;
+        setIndex({}, {});
+    });
+    if (g->isReady())
+        rebuild();
+}
+
+void SymbolView::rebuild()
+{
+    if (!m_debug || !m_debug->isGdbExecuting())
+        return;
+    int generation = ++m_generation;
+    m_retryOnStop = false;
+    m_status->setText(tr("Indexing..."));
+    m_debug->enqueue("-list-thread-groups", DebugManager::Priority_t::Refresh,
+                     [this, generation](const QVariant& res) {
+        if (generation != m_generation)
+            return;
+        QString executable;
+        for (const auto& e: res.toMap().value("groups").toList()) {
+            executable = e.toMap().value("executable").toString();
+            if (!executable.isEmpty())
+                break;
+        }
+        if (executable.isEmpty()) {
+            m_status->setText(tr("No executable loaded"));
+            return;
+        }
+        m_executable = executable;
+        auto path = SymbolIndex::cachePath(executable);
+        auto watcher = new QFutureWatcher<SymbolIndex>(this);
+        connect(watcher, &QFutureWatcher<SymbolIndex>::finished, this, [this, watcher, generation, executable]() {
+            watcher->deleteLater();
+            if (generation != m_generation)
+                return;
+            auto index = watcher->result();
+            if (index.isEmpty())
+                build(executable, generation);
+            else
+                setIndex(index, tr("cached"));
+        });
+        watcher->setFuture(QtConcurrent::run(&SymbolIndex::load, path));
+    }, [this, generation](const QVariant& res) {
+        if (generation == m_generation)
+            indexFailed(res);
+    });
+}
+
+void SymbolView::build(const QString &executable, int generation)
+{
+    auto path = SymbolIndex::cachePath(executable);
+    m_debug->enqueue("-symbol-info-functions", DebugManager::Priority_t::Refresh,
+                     [this, generation, path](const QVariant& res) {
+        if (generation != m_generation)
+            return;
+        // Converting and sorting 100k symbols stays off the GUI thread
+        auto watcher = new QFutureWatcher<SymbolIndex>(this);
+        connect(watcher, &QFutureWatcher<SymbolIndex>::finished, this, [this, watcher, generation]() {
+            watcher->deleteLater();
+            if (generation == m_generation)
+                setIndex(watcher->result(), tr("built"));
+        });
+        watcher->setFuture(QtConcurrent::run(&buildAndSave, res.toMap().value("symbols").toMap(), path));
+    }, [this, generation](const QVariant& res) {
+        if (generation == m_generation)
+            indexFailed(res);
+    });
+}
+
+void SymbolView::indexFailed(const QVariant &res)
+{
+    // An all-stop gdb refuses symbol queries while the inferior runs
+    if (m_debug->isInferiorRunning() || DebugManager::isCancelled(res)) {
+        m_retryOnStop = true;
+        m_status->setText(tr("Indexing at the next stop"));
+        return;
+    }
+    m_status->setText(tr("Cannot index symbols: %1").arg(res.toMap().value("msg").toString()));
+}
+
+void SymbolView::setIndex(const SymbolIndex &index, const QString &origin)
+{
+    m_index = index;
+    m_model->removeRows(0, m_model->rowCount());
+    m_status->setText(m_index.isEmpty()? QString{} : tr("%1 functions (%2)").arg(m_index.size()).arg(origin));
+    if (!m_query->text().isEmpty())
+        search(m_query->text());
+}
+
+void SymbolView::search(const QString &text)
+{
+    PERF_SCOPE("SymbolView::search");
+    QElapsedTimer clock;
+    clock.start();
+    auto found = m_index.search(text);
+    auto elapsed = clock.nsecsElapsed();
+    m_model->removeRows(0, m_model->rowCount());
+    for (auto i: found) {
+        const auto& sym = m_index.at(i);
+        auto name = new QStandardItem{sym.name};
+        name->setData(i);
+        auto location = sym.file.isEmpty()?
+                    QString{"0x%1"}.arg(sym.addr, 0, 16) :
+                    QString{"%1:%2"}.arg(QFileInfo{sym.file}.fileName()).arg(sym.line);
+        auto where = new QStandardItem{location};
+        where->setToolTip(sym.file);
+        m_model->appendRow({ name, where });
+    }
+    if (!m_index.isEmpty())
+        m_status->setText(tr("%1 of %2 functions, %3 ms")
+                          .arg(found.size()).arg(m_index.size()).arg(elapsed / 1e6, 0, 'f', 3));
+    if (!found.isEmpty())
+        m_view->selectRow(0);
+}
+
+const SymbolIndex::Symbol *SymbolView::currentSymbol() const
+{
+    auto idx = m_view->currentIndex();
+    if (!idx.isValid())
+        return nullptr;
+    auto item = m_model->item(idx.row(), 0);
+    return item? &m_index.at(item->data().toInt()) : nullptr;
+}
+
+void SymbolView::activate()
+{
+    auto sym = currentSymbol();
+    if (sym && !sym->file.isEmpty())
+        emit locationActivated(sym->file, sym->line);
+}
+
+void SymbolView::insertBreakpoint()
+{
+    auto sym = currentSymbol();
+    if (!sym || !m_debug || !m_debug->isGdbExecuting())
+        return;
+    if (sym->file.isEmpty())
+        m_debug->breakInsert(QString{"*0x%1"}.arg(sym->addr, 0, 16));
+    else
+        m_debug->breakInsert(QString{"%1:%2"}.arg(sym->file).arg(sym->line));
+}
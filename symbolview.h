@@ -0,0 +1,53 @@
+#ifndef SYMBOLVIEW_H
+#define SYMBOLVIEW_H
+
+#include <QWidget>
+
+#include "symbolindex.h"
+
+class DebugManager;
+class QLabel;
+class QLineEdit;
+class QStandardItemModel;
+class QTableView;
+
+class SymbolView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SymbolView(QWidget *parent = nullptr);
+
+    void setDebugManager(DebugManager *g);
+
+signals:
+    void locationActivated(const QString& file, int line);
+
+public slots:
+    // Loads the index of the debugged executable, building it when not cached
+    void rebuild();
+
+private slots:
+    void search(const QString& text);
+    void activate();
+    void insertBreakpoint();
+
+private:
+    void setIndex(const SymbolIndex& index, const QString& origin);
+    void build(const QString& executable, int generation);
+    void indexFailed(const QVariant& res);
+    const SymbolIndex::Symbol *currentSymbol() const;
+
+    DebugManager *m_debug = nullptr;
+    SymbolIndex m_index;
+    QString m_executable;
+    QLineEdit *m_query;
+    QTableView *m_view;
+    QStandardItemModel *m_model;
+    QLabel *m_status;
+    // Bumped per rebuild, results of an older one are dropped
+    int m_generation = 0;
+    bool m_retryOnStop = false;
+};
+
+#endif // SYMBOLVIEW_H
@@ -0,0 +1,165 @@
+#include "midecoder.h"
+
+#include <QtTest>
+
+#include <random>
+
+// Decoder used before mi::unescape: drops the backslash of every escape and
+// keeps the next character as is. It agrees with mi::unescape on every
+// escape that is not a C escape letter or an octal digit.
+static QString legacyParseString(const QString& s, int *stop)
+{
+    QString v;
+    auto it = s.cbegin();
+    while (it != s.cend()) {
+        if (*it == '"')
+            break;
+        if (*it == '\\')
+            if (++it == s.cend())
+                break;
+        v += *it++;
+    }
+    *stop = int(it - s.cbegin()) + (it != s.cend()? 1 : 0);
+    return v;
+}
+
+// Escapes text the way gdb prints MI c-strings: C escapes for the usual
+// control characters, octal bytes for the rest and for UTF-8 sequences
+static QString gdbEscape(const QString& text)
+{
+    QString out;
+    for (const auto& c: text) {
+        auto u = c.unicode();
+        switch (u) {
+        case '\\': out += "\\\\"; continue;
+        case '"': out += "\\\""; continue;
+        case '\n': out += "\\n"; continue;
+        case '\t': out += "\\t"; continue;
+        case '\r': out += "\\r"; continue;
+        case '\a': out += "\\a"; continue;
+        case '\b': out += "\\b"; continue;
+        case '\f': out += "\\f"; continue;
+        case '\v': out += "\\v"; continue;
+        case 0x1b: out += "\\e"; continue;
+        }
+        if (u >= 0x20 && u < 0x7f) {
+            out += c;
+            continue;
+        }
+        for (auto b: QString{c}.toUtf8())
+            out += QString{"\\%1"}.arg(uint(uchar(b)), 3, 8, QChar{'0'});
+    }
+    return out;
+}
+
+static QString unescaped(const QString& s, bool quoted, int *stop = nullptr)
+{
+    QString v;
+    auto end = mi::unescape(s.cbegin(), s.cend(), quoted, &v);
+    if (stop)
+        *stop = int(end - s.cbegin());
+    return v;
+}
+
+class TestUnescape : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cases_data();
+    void cases();
+    void roundTrip();
+    void matchesLegacy();
+    void truncated();
+};
+
+void TestUnescape::cases_data()
+{
+    QTest::addColumn<QString>("input");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("plain") << "hello" << "hello";
+    QTest::newRow("empty") << "" << "";
+    QTest::newRow("c escapes") << "a\\nb\\tc\\rd\\ae\\bf\\fg\\vh\\ei"
+                               << QString{"a\nb\tc\rd\ae\bf\fg\vh"} + QChar{0x1b} + "i";
+    QTest::newRow("quote and backslash") << "\\\"x\\\\y" << "\"x\\y";
+    QTest::newRow("octal ascii") << "\\101\\102" << "AB";
+    QTest::newRow("octal utf-8") << "caf\\303\\251" << QString::fromUtf8("caf\xc3\xa9");
+    QTest::newRow("octal at end") << "x\\303\\251" << QString::fromUtf8("x\xc3\xa9");
+    QTest::newRow("short octal") << "\\7x" << QString{"\ax"};
+    QTest::newRow("octal then digit") << "\\0618" << "18";
+    QTest::newRow("short octal at end") << "a\\12" << "a\n";
+    QTest::newRow("trailing backslash") << "abc\\" << "abc";
+    QTest::newRow("unknown escape") << "\\q\\{" << "q{";
+    QTest::newRow("octal nul") << "a\\000b" << QString{"a"} + QChar{0} + "b";
+}
+
+void TestUnescape::cases()
+{
+    QFETCH(QString, input);
+    QFETCH(QString, expected);
+    QCOMPARE(unescaped(input, false), expected);
+}
+
+void TestUnescape::roundTrip()
+{
+    std::mt19937 rng{20201018};
+    std::uniform_int_distribution<int> length{0, 64};
+    std::uniform_int_distribution<int> kind{0, 9};
+    std::uniform_int_distribution<int> ascii{0, 0x7f};
+    std::uniform_int_distribution<int> bmp{0x80, 0xfffd};
+    for (int n = 0; n < 20000; n++) {
+        QString text;
+        for (int i = length(rng); i > 0; i--) {
+            int u = kind(rng) < 7? ascii(rng) : bmp(rng);
+            if (u >= 0xd800 && u <= 0xdfff)
+                u = 0xfffd;
+            text += QChar{ushort(u)};
+        }
+        auto escaped = gdbEscape(text);
+        QCOMPARE(unescaped(escaped, false), text);
+        // Quoted mode stops right after the closing quote
+        int stop = -1;
+        QCOMPARE(unescaped(escaped + "\",x=\"1\"", true, &stop), text);
+        QCOMPARE(stop, escaped.size() + 1);
+    }
+}
+
+void TestUnescape::matchesLegacy()
+{
+    // Alphabet without C escape letters and octal digits, where the legacy
+    // decoder was already right
+    const QString alphabet = QString::fromUtf8("xy Z{}=,\\\"\xc3\xa9");
+    std::mt19937 rng{18102020};
+    std::uniform_int_distribution<int> length{0, 48};
+    std::uniform_int_distribution<int> pick{0, alphabet.size() - 1};
+    for (int n = 0; n < 20000; n++) {
+        QString s;
+        for (int i = length(rng); i > 0; i--)
+            s += alphabet.at(pick(rng));
+        int legacyStop = -1;
+        int stop = -1;
+        auto legacy = legacyParseString(s, &legacyStop);
+        QCOMPARE(unescaped(s, true, &stop), legacy);
+        QCOMPARE(stop, legacyStop);
+    }
+}
+
+void TestUnescape::truncated()
+{
+    // Every prefix of an escaped string must decode without reading past
+    // its end, whatever escape it is cut in
+    auto escaped = gdbEscape(QString::fromUtf8("a\n\"\\\xc3\xa9\x01z"));
+    for (int i = 0; i <= escaped.size(); i++) {
+        auto prefix = escaped.left(i);
+        int stop = -1;
+        unescaped(prefix, true, &stop);
+        QVERIFY(stop >= 0 && stop <= prefix.size());
+        unescaped(prefix, false, &stop);
+        QCOMPARE(stop, prefix.size());
+    }
+}
+
+QTEST_APPLESS_MAIN(TestUnescape)
+
+#include "tst_unescape.moc"
@@ -0,0 +1,16 @@
+QT += testlib
+QT -= gui
+
+CONFIG += c++11 testcase console
+CONFIG -= app_bundle
+
+TARGET = tst_unescape
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../midecoder.cpp \
+    tst_unescape.cpp
+
+HEADERS += \
+    ../../midecoder.h